@@ -0,0 +1,37 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "boardState.hpp"
+#include "mctsClass.hpp"
+#include "strategyClass.hpp"
+
+/**
+ * MctsAgent
+ *
+ * Description:
+ *      Agent wrapper around MctsPlayer with a per-move time budget. Searches
+ *      single-threaded by default so a tournament can run one game per core.
+ */
+class MctsAgent : public Agent {
+   public:
+    MctsAgent(std::chrono::microseconds budget, unsigned threads = 1, uint64_t seed = 1)
+        : budget(budget), threads(threads), seed(seed), player(threads, budget, seed) {}
+
+    int choose(const GameState &state, int roll) override { return player.choose(state, roll); }
+
+    std::string name() const override {
+        return "mcts-" + std::to_string(std::chrono::duration_cast<std::chrono::milliseconds>(budget).count()) + "ms";
+    }
+
+    std::unique_ptr<Agent> clone() const override { return std::unique_ptr<Agent>(new MctsAgent(budget, threads, seed + 1)); }
+
+   private:
+    std::chrono::microseconds budget;
+    unsigned threads;
+    uint64_t seed;
+    MctsPlayer player;
+};
@@ -0,0 +1,410 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * ColumnTables
+ *
+ * Description:
+ *      Lookup tables built at compile time for columns of `Rows` cells holding
+ *      dice with `Sides` faces. `packed` lists every possible column content
+ *      (sorted descending, empties last, one byte per row) and `index` maps
+ *      any raw column, read as a base (Sides + 1) number with row 0 first, to
+ *      its position in that list. `bits()` is how many bits that position needs.
+ */
+template <int Rows, int Sides>
+struct ColumnTables {
+    static constexpr int base = Sides + 1;
+
+    static constexpr int raw_count() {
+        int n = 1;
+        for (int i = 0; i < Rows; ++i)
+            n *= base;
+        return n;
+    }
+
+    // multisets of Rows values from 0..Sides = C(Rows + Sides, Rows)
+    static constexpr int count() {
+        long long n = 1;
+        for (int i = 1; i <= Rows; ++i)
+            n = n * (Sides + i) / i;
+        return static_cast<int>(n);
+    }
+
+    static constexpr int bits() {
+        int b = 0;
+        while ((1 << b) < count())
+            ++b;
+        return b;
+    }
+
+    uint16_t index[raw_count()] = {};
+    uint64_t packed[count()]    = {};
+
+    constexpr ColumnTables() {
+        // first pass: number the columns that are already sorted, in raw order
+        int n = 0;
+        for (int raw = 0; raw < raw_count(); ++raw) {
+            int digits[Rows] = {};
+            if (!decode(raw, digits))
+                continue;
+            uint64_t p = 0;
+            for (int row = 0; row < Rows; ++row)
+                p |= static_cast<uint64_t>(digits[row]) << (8 * row);
+            packed[n]  = p;
+            index[raw] = static_cast<uint16_t>(n++);
+        }
+        // second pass: every other column shares the number of its sorted
+        // form, so holes left by removals collapse to the end
+        for (int raw = 0; raw < raw_count(); ++raw) {
+            int digits[Rows] = {};
+            if (decode(raw, digits))
+                continue;
+            for (int i = 1; i < Rows; ++i) {
+                for (int j = i; j > 0 && digits[j - 1] < digits[j]; --j) {
+                    int t         = digits[j];
+                    digits[j]     = digits[j - 1];
+                    digits[j - 1] = t;
+                }
+            }
+            int sorted = 0;
+            for (int row = 0; row < Rows; ++row)
+                sorted = sorted * base + digits[row];
+            index[raw] = index[sorted];
+        }
+    }
+
+   private:
+    // Splits `raw` into row values; true if they are already non-increasing
+    static constexpr bool decode(int raw, int (&digits)[Rows]) {
+        for (int row = Rows - 1; row >= 0; --row) {
+            digits[row] = raw % base;
+            raw /= base;
+        }
+        for (int row = 1; row < Rows; ++row) {
+            if (digits[row] > digits[row - 1])
+                return false;
+        }
+        return true;
+    }
+};
+
+template <int Rows, int Sides>
+inline constexpr ColumnTables<Rows, Sides> column_tables{};
+
+/**
+ * BasicCanonicalKey
+ *
+ * Description:
+ *      Result of GameState::canonical(). Swapping columns the same way on both
+ *      boards does not change a position, so every ordering of the columns
+ *      shares the key of the smallest one. `perm[i]` is the original column
+ *      that sits at canonical column i, which is how moves are mapped between
+ *      the two.
+ */
+template <int Cols>
+struct BasicCanonicalKey {
+    uint64_t key;
+    uint8_t perm[Cols];
+
+    int to_original(int canonical_column) const { return perm[canonical_column]; }
+
+    int to_canonical(int original_column) const {
+        for (int i = 0; i < Cols; ++i) {
+            if (perm[i] == original_column)
+                return i;
+        }
+        return -1;
+    }
+};
+
+/**
+ * BasicGameState
+ *
+ * Description:
+ *      Compact, copyable snapshot of a two-player Knucklebones position on
+ *      `Rows` x `Cols` boards with `Sides`-sided dice. It uses the same rules
+ *      as `Player` in main.cpp: a die goes into the first empty row of the
+ *      chosen column, the first matching die in the opponent's same column is
+ *      removed, and a column scores its sum plus (count - 1) * value * count
+ *      for every repeated value. The game is over once either board is full.
+ *
+ *      Sizes are template parameters, so every loop below has a constant trip
+ *      count that the compiler unrolls and folds per variant. `GameState` is
+ *      the standard 3x3 board with six-sided dice; the common variants are
+ *      explicitly instantiated in boardVariants.cpp.
+ *
+ *      Boards are stored as grid[player][column][row] to match `Player::grid`.
+ *
+ * Public Methods:
+ *      - bool column_full(int player, int column) const : True if the column has no empty row.
+ *      - bool board_full(int player) const               : True if every cell of the board is used.
+ *      - bool is_over() const                            : True once either board is full.
+ *      - int  score(int player) const                    : Score of a board.
+ *      - void place(int column, int value)               : Plays a die for the side to move.
+ *      - Undo make_move(int column, int value)           : Same as place, returns how to take it back.
+ *      - void unmake_move(const Undo& u)                 : Restores the state from before make_move.
+ *      - uint64_t key() const                            : Compact encoding, equal for equivalent states.
+ *      - CanonicalKey canonical() const                  : Key of the column permutation with the smallest key.
+ *      - bool parse_board(int player, const std::string& text) : Reads a board typed column by column, '.' for empty.
+ *
+ * Usage:
+ *      GameState s;                     // empty boards, player 0 to move
+ *      s.place(1, 4);                   // player 0 puts a 4 in column 1
+ *      uint64_t k = s.canonical().key;  // key for hash tables / solution tables
+ *
+ *      auto undo = s.make_move(0, 6);   // search in place, no copies
+ *      s.unmake_move(undo);
+ *
+ *      BasicGameState<4, 4, 8> big;     // 4x4 boards with eight-sided dice
+ */
+template <int Rows, int Cols, int Sides>
+struct BasicGameState {
+    static constexpr int rows  = Rows;
+    static constexpr int cols  = Cols;
+    static constexpr int sides = Sides;
+
+    using Tables       = ColumnTables<Rows, Sides>;
+    using CanonicalKey = BasicCanonicalKey<Cols>;
+
+    static constexpr int column_bits = Tables::bits();
+    // True when key() is lossless and from_key() can reverse it; larger
+    // variants fall back to a 64-bit hash of the same column numbers
+    static constexpr bool exact_key = 2 * Cols * column_bits + 1 <= 64;
+
+    uint8_t grid[2][Cols][Rows] = {};  // [player][column][row], 0 means empty
+    uint8_t turn                = 0;   // player to move (0 or 1)
+
+    bool column_full(int player, int column) const {
+        for (int row = 0; row < Rows; ++row) {
+            if (grid[player][column][row] == 0)
+                return false;
+        }
+        return true;
+    }
+
+    bool board_full(int player) const {
+        for (int col = 0; col < Cols; ++col) {
+            if (!column_full(player, col))
+                return false;
+        }
+        return true;
+    }
+
+    bool is_over() const { return board_full(0) || board_full(1); }
+
+    int dice_count() const {
+        int n = 0;
+        for (int p = 0; p < 2; ++p)
+            for (int col = 0; col < Cols; ++col)
+                for (int row = 0; row < Rows; ++row)
+                    n += grid[p][col][row] != 0;
+        return n;
+    }
+
+    static int column_score(const uint8_t column[Rows]) {
+        int counts[Sides + 1] = {};
+        int col_score         = 0;
+        for (int row = 0; row < Rows; ++row) {
+            if (column[row] > 0) {
+                counts[column[row]]++;
+                col_score += column[row];
+            }
+        }
+        for (int value = 1; value <= Sides; ++value) {
+            if (counts[value] > 1)
+                col_score += (counts[value] - 1) * value * counts[value];
+        }
+        return col_score;
+    }
+
+    int score(int player) const {
+        int total = 0;
+        for (int col = 0; col < Cols; ++col)
+            total += column_score(grid[player][col]);
+        return total;
+    }
+
+    // What make_move changed: enough to put every cell back exactly
+    struct Undo {
+        int8_t column;
+        int8_t placed_row;   // row the die went into
+        int8_t removed_row;  // row of the opponent die knocked out, -1 if none
+    };
+
+    // Plays `value` into `column` for the side to move; the caller checks legality
+    Undo make_move(int column, int value) {
+        Undo u{static_cast<int8_t>(column), 0, -1};
+        uint8_t *mine = grid[turn][column];
+        for (int row = 0; row < Rows; ++row) {
+            if (mine[row] == 0) {
+                mine[row]    = static_cast<uint8_t>(value);
+                u.placed_row = static_cast<int8_t>(row);
+                break;
+            }
+        }
+        uint8_t *theirs = grid[turn ^ 1][column];
+        for (int row = 0; row < Rows; ++row) {
+            if (theirs[row] == value) {
+                theirs[row]   = 0;
+                u.removed_row = static_cast<int8_t>(row);
+                break;
+            }
+        }
+        turn ^= 1;
+        return u;
+    }
+
+    // Reverses the make_move that returned `u`; moves must be undone last-in first-out
+    void unmake_move(const Undo &u) {
+        turn ^= 1;
+        uint8_t value = grid[turn][u.column][u.placed_row];
+        if (u.removed_row >= 0)
+            grid[turn ^ 1][u.column][u.removed_row] = value;
+        grid[turn][u.column][u.placed_row] = 0;
+    }
+
+    void place(int column, int value) { make_move(column, value); }
+
+    // Number of a column's multiset of dice; row order does not affect play
+    static int column_index(const uint8_t column[Rows]) {
+        int raw = 0;
+        for (int row = 0; row < Rows; ++row)
+            raw = raw * Tables::base + column[row];
+        return column_tables<Rows, Sides>.index[raw];
+    }
+
+    // column_bits per column, player 1's columns above player 2's, then the side to move
+    uint64_t key() const {
+        uint64_t k[2] = {0, 0};
+        for (int p = 0; p < 2; ++p)
+            for (int col = 0; col < Cols; ++col)
+                k[p] = (k[p] << column_bits) | static_cast<uint64_t>(column_index(grid[p][col]));
+        return combine(k[0], k[1]);
+    }
+
+    // Inverse of key(). A template so only a call instantiates it: on a variant
+    // whose key is a hash it is a compile error rather than an empty state
+    template <bool Exact = exact_key>
+    static BasicGameState from_key(uint64_t k) {
+        static_assert(Exact, "from_key needs an exact key; this variant's key() is a hash");
+        BasicGameState s;
+        const uint64_t mask = (uint64_t(1) << column_bits) - 1;
+        s.turn              = static_cast<uint8_t>((k >> (2 * Cols * column_bits)) & 1);
+        for (int p = 1; p >= 0; --p) {
+            for (int col = Cols - 1; col >= 0; --col) {
+                uint64_t packed = column_tables<Rows, Sides>.packed[k & mask];
+                for (int row = 0; row < Rows; ++row)
+                    s.grid[p][col][row] = static_cast<uint8_t>((packed >> (8 * row)) & 0xFF);
+                k >>= column_bits;
+            }
+        }
+        return s;
+    }
+
+    // Sorts the columns by (player 1 column, player 2 column) with a branchless
+    // odd-even network; the column number rides in the low bits of each code
+    CanonicalKey canonical() const {
+        constexpr int col_bits = Cols <= 2 ? 1 : (Cols <= 4 ? 2 : (Cols <= 8 ? 3 : 4));
+        uint32_t code[Cols];
+        for (int col = 0; col < Cols; ++col) {
+            code[col] = (static_cast<uint32_t>(column_index(grid[0][col])) << (column_bits + col_bits)) |
+                        (static_cast<uint32_t>(column_index(grid[1][col])) << col_bits) | static_cast<uint32_t>(col);
+        }
+        for (int pass = 0; pass < Cols; ++pass) {
+            for (int i = pass % 2; i + 1 < Cols; i += 2) {
+                uint32_t lo = std::min(code[i], code[i + 1]);
+                uint32_t hi = std::max(code[i], code[i + 1]);
+                code[i]     = lo;
+                code[i + 1] = hi;
+            }
+        }
+        CanonicalKey c;
+        const uint32_t mask = (1u << column_bits) - 1;
+        uint64_t k[2]       = {0, 0};
+        for (int i = 0; i < Cols; ++i) {
+            c.perm[i] = static_cast<uint8_t>(code[i] & ((1u << col_bits) - 1));
+            k[0]      = (k[0] << column_bits) | (code[i] >> (column_bits + col_bits));
+            k[1]      = (k[1] << column_bits) | ((code[i] >> col_bits) & mask);
+        }
+        c.key = combine(k[0], k[1]);
+        return c;
+    }
+
+    // Builds a state from the `Player::grid` layout of each player
+    template <typename GridT>
+    static BasicGameState from_grids(const GridT &g0, const GridT &g1, int turn) {
+        BasicGameState s;
+        for (int col = 0; col < Cols; ++col) {
+            for (int row = 0; row < Rows; ++row) {
+                s.grid[0][col][row] = static_cast<uint8_t>(g0[col][row]);
+                s.grid[1][col][row] = static_cast<uint8_t>(g1[col][row]);
+            }
+        }
+        s.turn = static_cast<uint8_t>(turn);
+        return s;
+    }
+
+    // Fills one board from Rows * Cols characters, column by column, '.' or '0' for empty;
+    // false (board untouched) if the length is wrong or a die is not 1..Sides
+    bool parse_board(int player, const std::string &text) {
+        if (text.size() != static_cast<size_t>(Rows * Cols))
+            return false;
+        uint8_t board[Cols][Rows];
+        for (int col = 0; col < Cols; ++col) {
+            for (int row = 0; row < Rows; ++row) {
+                char ch = text[col * Rows + row];
+                if (ch == '.')
+                    ch = '0';
+                if (ch < '0' || ch > '0' + Sides)
+                    return false;
+                board[col][row] = static_cast<uint8_t>(ch - '0');
+            }
+        }
+        std::copy(&board[0][0], &board[0][0] + Rows * Cols, &grid[player][0][0]);
+        return true;
+    }
+
+    std::string to_string() const {
+        std::string out;
+        for (int p = 0; p < 2; ++p) {
+            out += (p == turn) ? "*P" : " P";
+            out += std::to_string(p + 1) + " [";
+            for (int col = 0; col < Cols; ++col) {
+                for (int row = 0; row < Rows; ++row)
+                    out += grid[p][col][row] ? static_cast<char>('0' + grid[p][col][row]) : '.';
+                if (col < Cols - 1)
+                    out += ' ';
+            }
+            out += "] " + std::to_string(score(p)) + "\n";
+        }
+        return out;
+    }
+
+   private:
+    uint64_t combine(uint64_t k0, uint64_t k1) const {
+        if constexpr (exact_key) {
+            return (k0 << (Cols * column_bits)) | k1 | (static_cast<uint64_t>(turn) << (2 * Cols * column_bits));
+        } else {
+            // splitmix64 finalizer over both boards and the side to move
+            uint64_t h = (k0 * 0x9E3779B97F4A7C15ull) ^ (k1 + 0x632BE59BD9B4E019ull) ^ (static_cast<uint64_t>(turn) << 63);
+            h ^= h >> 31;
+            h *= 0xBF58476D1CE4E5B9ull;
+            h ^= h >> 29;
+            return h;
+        }
+    }
+};
+
+using GameState    = BasicGameState<3, 3, 6>;
+using CanonicalKey = GameState::CanonicalKey;
+
+// Common variants are compiled once in boardVariants.cpp
+extern template struct BasicGameState<3, 3, 6>;
+extern template struct BasicGameState<3, 3, 8>;
+extern template struct BasicGameState<4, 4, 6>;
+extern template struct BasicGameState<4, 4, 8>;
@@ -0,0 +1,25 @@
+#include "boardState.hpp"  // game state template
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Board Variants
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Explicit instantiations of the common BasicGameState variants. The
+*        header declares them `extern`, so every program links this one copy
+*        instead of compiling each variant again. Other sizes still work by
+*        including boardState.hpp and naming the template.
+*
+*  Usage:
+*        - Add `boardVariants.cpp` to the compile line of any program that
+*          includes boardState.hpp.
+*****************************************************************************/
+
+template struct BasicGameState<3, 3, 6>;  // standard game
+template struct BasicGameState<3, 3, 8>;  // d8 dice
+template struct BasicGameState<4, 4, 6>;  // 4x4 boards
+template struct BasicGameState<4, 4, 8>;  // 4x4 boards with d8 dice
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boardState.hpp"
+#include "strategyClass.hpp"
+
+/**
+ * OpeningBook
+ *
+ * Description:
+ *      Read-only table of precomputed moves for early positions, stored so
+ *      the file can be mapped and searched in place with no parsing.
+ *
+ *      File layout (native endian):
+ *          64-byte header : magic "KBBOOK1", entry count, plies, die sides
+ *          entries        : 16 bytes each, { canonical key, best column per roll }
+ *
+ *      Entries are in Eytzinger (BFS heap) order: entry 1 is the median key,
+ *      the children of entry i are 2i and 2i+1, and entry 0 is padding. A
+ *      lookup walks down the implicit tree with a branch-free step; the first
+ *      levels share a few cache lines, so a probe costs a handful of misses
+ *      at most instead of log2(n) scattered ones for binary search.
+ *
+ *      Keys are canonical (see GameState::canonical()) and moves are stored
+ *      in canonical column order, so each position appears once no matter how
+ *      its columns are arranged.
+ *
+ * Public Methods:
+ *      - bool open(const std::string& path)             : Maps a book, false if missing or invalid.
+ *      - int  lookup(const GameState& s, int roll) const : Column to play, -1 if s is not in the book.
+ *      - size_t size() const / int plies() const
+ *      - static bool write(path, entries, plies)         : Builds a book file from unsorted entries.
+ *
+ * Usage:
+ *      OpeningBook book;
+ *      if (book.open("opening.book")) column = book.lookup(state, roll);
+ */
+class OpeningBook {
+   public:
+    static constexpr int max_sides = 8;
+
+    struct Entry {
+        uint64_t key;
+        uint8_t moves[max_sides];  // canonical column for each roll, no_move if unknown
+    };
+    static constexpr uint8_t no_move = 0xFF;
+
+    OpeningBook() {}
+    OpeningBook(const OpeningBook &)            = delete;
+    OpeningBook &operator=(const OpeningBook &) = delete;
+    ~OpeningBook() { close(); }
+
+    bool open(const std::string &path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0)
+            return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(Header)) {
+            ::close(fd);
+            return false;
+        }
+        void *p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // the mapping keeps the file alive
+        if (p == MAP_FAILED)
+            return false;
+        mapped = p;
+        length = static_cast<size_t>(st.st_size);
+
+        const Header *h = static_cast<const Header *>(mapped);
+        if (std::memcmp(h->magic, magic, sizeof(h->magic)) != 0 || h->sides != GameState::sides ||
+            length != sizeof(Header) + (h->count + 1) * sizeof(Entry)) {
+            close();
+            return false;
+        }
+        madvise(mapped, length, MADV_WILLNEED);
+        entries = reinterpret_cast<const Entry *>(static_cast<const char *>(mapped) + sizeof(Header));
+        count   = h->count;
+        depth   = static_cast<int>(h->plies);
+        return true;
+    }
+
+    void close() {
+        if (mapped)
+            munmap(mapped, length);
+        mapped  = nullptr;
+        entries = nullptr;
+        count   = 0;
+    }
+
+    int lookup(const GameState &s, int roll) const {
+        if (!count)
+            return -1;
+        GameState::CanonicalKey c = s.canonical();
+        const Entry *e            = find(c.key);
+        if (!e || e->moves[roll - 1] == no_move)
+            return -1;
+        return c.to_original(e->moves[roll - 1]);
+    }
+
+    size_t size() const { return count; }
+    int plies() const { return depth; }
+
+    static bool write(const std::string &path, std::vector<Entry> sorted, int plies) {
+        // sorted here; callers may pass entries in any order
+        std::sort(sorted.begin(), sorted.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+        std::vector<Entry> layout(sorted.size() + 1);
+        std::memset(layout.data(), 0, sizeof(Entry));
+        size_t next = 0;
+        fill(sorted, layout, next, 1);
+
+        Header h;
+        std::memset(&h, 0, sizeof(h));
+        std::memcpy(h.magic, magic, sizeof(h.magic));
+        h.count = sorted.size();
+        h.plies = static_cast<uint32_t>(plies);
+        h.sides = GameState::sides;
+
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        file.write(reinterpret_cast<const char *>(layout.data()), static_cast<std::streamsize>(layout.size() * sizeof(Entry)));
+        return file.good();
+    }
+
+   private:
+    struct Header {
+        char magic[8];
+        uint64_t count;
+        uint32_t plies;
+        uint32_t sides;
+        uint8_t reserved[40];  // pads entries to a cache line boundary
+    };
+    static_assert(sizeof(Header) == 64, "book header must stay 64 bytes");
+    static_assert(sizeof(Entry) == 16, "book entries must stay 16 bytes");
+    static_assert(GameState::exact_key, "a book keyed on a hashed key() could mix positions up silently");
+    static_assert(GameState::sides <= max_sides, "book stores at most max_sides rolls");
+    static constexpr char magic[8] = {'K', 'B', 'B', 'O', 'O', 'K', '1', '\0'};
+
+    void *mapped         = nullptr;
+    size_t length        = 0;
+    const Entry *entries = nullptr;
+    uint64_t count       = 0;
+    int depth            = 0;
+
+    const Entry *find(uint64_t key) const {
+        uint64_t k = 1;
+        while (k <= count) {
+            __builtin_prefetch(entries + k * 16);  // the subtree four levels down
+            k = 2 * k + (entries[k].key < key);
+        }
+        // drop the trailing right turns and the final left turn
+        k >>= __builtin_ffsll(static_cast<long long>(~k));
+        return (k && entries[k].key == key) ? entries + k : nullptr;
+    }
+
+    // In-order walk of the implicit tree hands out the sorted entries
+    static void fill(const std::vector<Entry> &sorted, std::vector<Entry> &layout, size_t &next, size_t k) {
+        if (k > sorted.size())
+            return;
+        fill(sorted, layout, next, 2 * k);
+        layout[k] = sorted[next++];
+        fill(sorted, layout, next, 2 * k + 1);
+    }
+};
+
+/**
+ * BookAgent
+ *
+ * Description:
+ *      Plays from an opening book while the position is in it and asks the
+ *      fallback agent otherwise. The book is shared read-only between clones.
+ *
+ * Usage:
+ *      auto book = std::make_shared<OpeningBook>();
+ *      book->open("opening.book");
+ *      std::unique_ptr<Agent> bot(new BookAgent(book, std::unique_ptr<Agent>(new GreedyAgent())));
+ */
+class BookAgent : public Agent {
+   public:
+    BookAgent(std::shared_ptr<const OpeningBook> book, std::unique_ptr<Agent> fallback)
+        : book(std::move(book)), fallback(std::move(fallback)) {}
+
+    int choose(const GameState &state, int roll) override {
+        int col = book->lookup(state, roll);
+        return col >= 0 ? col : fallback->choose(state, roll);
+    }
+
+    std::string name() const override { return fallback->name() + "+book"; }
+
+    std::unique_ptr<Agent> clone() const override {
+        return std::unique_ptr<Agent>(new BookAgent(book, fallback->clone()));
+    }
+
+   private:
+    std::shared_ptr<const OpeningBook> book;
+    std::unique_ptr<Agent> fallback;
+};
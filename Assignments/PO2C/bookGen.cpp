@@ -0,0 +1,142 @@
+#include "boardState.hpp"     // compact game state
+#include "bookClass.hpp"      // opening book file format
+#include "strategyClass.hpp"  // expectimax search for the book moves
+#include <atomic>             // work counter
+#include <chrono>             // timing
+#include <cstdio>             // printf
+#include <cstdlib>            // strtoul
+#include <iostream>           // input/output
+#include <string>             // string data structure
+#include <thread>             // worker threads
+#include <unordered_set>      // seen positions
+#include <vector>             // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Opening Book Generator
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Finds every position reachable from the empty boards within N moves,
+*        picks the best column for each roll with a deep expectimax search
+*        and writes an opening book the game can map straight into memory.
+*        Afterwards it maps the new file and times lookups.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o bookGen bookGen.cpp boardVariants.cpp`
+*        - Run with `./bookGen <out_file> [plies] [search_depth] [threads]`
+*        - e.g. `./bookGen opening.book 4 4` books the first 4 moves at depth 4
+*
+*  Files:             bookGen.cpp       : generator driver
+*                     bookClass.hpp     : book format, lookup and BookAgent
+*                     strategyClass.hpp : expectimax search
+*****************************************************************************/
+
+/**
+ * book_positions
+ *
+ * Description:
+ *      Breadth-first walk from the empty boards over every roll and column,
+ *      keeping one representative per canonical key.
+ *
+ * Params:
+ *      int plies : positions after at most this many moves are kept
+ *
+ * Returns:
+ *      std::vector<GameState> : the positions, excluding finished games
+ */
+std::vector<GameState> book_positions(int plies) {
+    std::vector<GameState> out, frontier(1);
+    std::unordered_set<uint64_t> seen{frontier[0].canonical().key};
+    for (int ply = 0; ply <= plies; ++ply) {
+        std::vector<GameState> next;
+        for (const GameState &s : frontier) {
+            out.push_back(s);
+            if (ply == plies)
+                continue;
+            for (int roll = 1; roll <= GameState::sides; ++roll) {
+                for (int col = 0; col < GameState::cols; ++col) {
+                    if (s.column_full(s.turn, col))
+                        continue;
+                    GameState child = s;
+                    child.place(col, roll);
+                    if (!child.is_over() && seen.insert(child.canonical().key).second)
+                        next.push_back(child);
+                }
+            }
+        }
+        frontier.swap(next);
+    }
+    return out;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " <out_file> [plies] [search_depth] [threads]" << std::endl;
+        return 1;
+    }
+    int plies        = argc > 2 ? static_cast<int>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    int depth        = argc > 3 ? static_cast<int>(std::strtoul(argv[3], nullptr, 10)) : 4;
+    unsigned threads = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 0;
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto start                       = std::chrono::steady_clock::now();
+    std::vector<GameState> positions = book_positions(plies);
+    std::vector<OpeningBook::Entry> entries(positions.size());
+    std::cout << positions.size() << " positions within " << plies << " moves" << std::endl;
+
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&]() {
+            ExpectimaxStrategy search(depth);
+            for (size_t i = next++; i < positions.size(); i = next++) {
+                const GameState &s        = positions[i];
+                GameState::CanonicalKey c = s.canonical();
+                OpeningBook::Entry &e     = entries[i];
+                e.key                     = c.key;
+                for (int m = 0; m < OpeningBook::max_sides; ++m)
+                    e.moves[m] = OpeningBook::no_move;
+                for (int roll = 1; roll <= GameState::sides; ++roll)
+                    e.moves[roll - 1] = static_cast<uint8_t>(c.to_canonical(search.choose(s, roll)));
+            }
+        });
+    }
+    for (auto &th : pool)
+        th.join();
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "searched at depth " << depth << " in " << secs << "s" << std::endl;
+
+    if (!OpeningBook::write(argv[1], entries, plies)) {
+        std::cerr << "Unable to open file: " << argv[1] << std::endl;
+        return 1;
+    }
+
+    // check the file round trips and time the lookups the game will do
+    OpeningBook book;
+    if (!book.open(argv[1])) {
+        std::cerr << "Unable to map book: " << argv[1] << std::endl;
+        return 1;
+    }
+    size_t wrong  = 0;
+    int rounds    = std::max<int>(1, static_cast<int>(2000000 / positions.size()));
+    uint64_t sink = 0;
+    start         = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            int roll = static_cast<int>((i + r) % GameState::sides) + 1;
+            int col  = book.lookup(positions[i], roll);
+            sink += static_cast<uint64_t>(col);
+            if (r == 0 && col != positions[i].canonical().to_original(entries[i].moves[roll - 1]))
+                ++wrong;
+        }
+    }
+    secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%zu entries, %zu wrong, %.1f ns per lookup (checksum %llu)\n", book.size(), wrong,
+                1e9 * secs / (static_cast<double>(rounds) * positions.size()), static_cast<unsigned long long>(sink));
+    return wrong ? 1 : 0;
+}
@@ -4,6 +4,8 @@
 
 #include <string>
 
+#include "compositorClass.hpp"
+
 struct Frame {
     int h;  // Height
     int w;  // Width
@@ -11,7 +13,7 @@ struct Frame {
     int x;  // X-coordinate
 };
 
-class Button {
+class Button : public Widget {
    private:
     Frame frame;
     WINDOW *button_win;
@@ -32,7 +34,6 @@ class Button {
     }
     void draw_button() {
         box(button_win, 0, 0);  // Draw border around button
-        wrefresh(button_win);
         // Set color pair based on clicked state
         if (is_clicked) {
             wbkgd(button_win, COLOR_PAIR(on_color));  // Black background, white text
@@ -46,9 +47,11 @@ class Button {
         int wmiddle = (frame.w - text.length()) / 2;
         int hmiddle = (frame.h - 1) / 2;
         mvwprintw(button_win, hmiddle, wmiddle, text.c_str());
-        wrefresh(button_win);
+        present();  // border and text reach the screen together
     }
 
+    void stage() override { wnoutrefresh(button_win); }
+
     void toggle() {
         is_clicked = !is_clicked;
         draw_button();
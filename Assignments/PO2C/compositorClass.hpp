@@ -0,0 +1,182 @@
+#pragma once
+
+#include <ncurses.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+class Compositor;
+
+/**
+ * Widget
+ *
+ * Description:
+ *      Something drawn into its own ncurses window: a Button, a Grid, a die.
+ *      A widget draws without refreshing and then calls `present()`. If it
+ *      has been added to a Compositor that only marks it dirty, and the
+ *      compositor stages it with `stage()` (wnoutrefresh) at the next frame;
+ *      otherwise it goes to the terminal at once, as wrefresh used to.
+ *
+ * Public Methods:
+ *      - virtual void stage()   : Copies the window to ncurses' virtual screen.
+ *      - bool isDirty() const
+ *
+ * Usage:
+ *      class Clock : public Widget {
+ *          void stage() override { wnoutrefresh(win); }
+ *          ...draw into win, then present();
+ *      };
+ */
+class Widget {
+   public:
+    Widget() = default;
+    virtual ~Widget();
+
+    Widget(const Widget &)            = delete;
+    Widget &operator=(const Widget &) = delete;
+
+    virtual void stage() = 0;
+
+    bool isDirty() const { return dirty; }
+
+   protected:
+    // Call after drawing: staged for the next frame if composited, otherwise shown now
+    void present();
+
+    // present(), and for an animation frame that has to be seen: waits for the frame that shows it
+    void presentFrame();
+
+   private:
+    friend class Compositor;
+    Compositor *compositor = nullptr;
+    bool dirty             = false;
+};
+
+/**
+ * Compositor
+ *
+ * Description:
+ *      Puts a frame on the terminal in one write. Widgets added to it mark
+ *      themselves dirty when they draw; `frame()` stages every dirty widget
+ *      with wnoutrefresh and then calls doupdate once, so the terminal gets
+ *      one batch of output per frame instead of one per widget, and never
+ *      shows a frame half drawn. Frames are capped at `max_fps`: a frame
+ *      asked for too soon is left for the next call, with the widgets still
+ *      dirty, so nothing drawn is lost. Widgets are drawn in the order they
+ *      were added and are expected not to overlap.
+ *
+ * Public Methods:
+ *      - Compositor(int max_fps = 60)      : 0 for no cap.
+ *      - void add(Widget &w) / void remove(Widget &w)
+ *      - void setMaxFps(int max_fps)
+ *      - bool frame()                       : Draws a frame if one is due and anything changed.
+ *      - void waitFrame()                   : Sleeps until a frame is due, then draws it.
+ *      - uint64_t frames() const / uint64_t staged() const
+ *
+ * Usage:
+ *      Compositor screen(30);
+ *      Grid grid(0, 0);
+ *      DiceViz die(0, 20);
+ *      screen.add(grid);
+ *      screen.add(die);
+ *      die.draw_dice(4);      // only marks the die dirty
+ *      screen.frame();        // one doupdate for everything dirty
+ */
+class Compositor {
+   public:
+    explicit Compositor(int max_fps = 60) { setMaxFps(max_fps); }
+
+    ~Compositor() {
+        for (Widget *w : widgets)
+            w->compositor = nullptr;
+    }
+
+    Compositor(const Compositor &)            = delete;
+    Compositor &operator=(const Compositor &) = delete;
+
+    void add(Widget &w) {
+        if (w.compositor == this)
+            return;
+        if (w.compositor)
+            w.compositor->remove(w);
+        w.compositor = this;
+        widgets.push_back(&w);
+        // whatever it drew before it was added still has to reach the screen
+        w.dirty = true;
+        pending = true;
+    }
+
+    void remove(Widget &w) {
+        widgets.erase(std::remove(widgets.begin(), widgets.end(), &w), widgets.end());
+        if (w.compositor == this)
+            w.compositor = nullptr;
+    }
+
+    void setMaxFps(int max_fps) {
+        interval = max_fps > 0 ? std::chrono::steady_clock::duration(std::chrono::seconds(1)) / max_fps
+                               : std::chrono::steady_clock::duration::zero();
+    }
+
+    bool frame() {
+        if (!pending)
+            return false;
+        auto now = std::chrono::steady_clock::now();
+        if (now - last < interval)
+            return false;
+        for (Widget *w : widgets) {
+            if (w->dirty) {
+                w->stage();
+                w->dirty = false;
+                ++stagedCount;
+            }
+        }
+        doupdate();
+        pending = false;
+        last    = now;
+        ++frameCount;
+        return true;
+    }
+
+    void waitFrame() {
+        auto due = last + interval;
+        if (pending && std::chrono::steady_clock::now() < due)
+            std::this_thread::sleep_until(due);
+        frame();
+    }
+
+    uint64_t frames() const { return frameCount; }
+    uint64_t staged() const { return stagedCount; }
+
+   private:
+    friend class Widget;
+    std::vector<Widget *> widgets;  // in drawing order
+    std::chrono::steady_clock::duration interval;
+    std::chrono::steady_clock::time_point last;
+    bool pending         = false;  // some widget is dirty
+    uint64_t frameCount  = 0;
+    uint64_t stagedCount = 0;
+};
+
+inline Widget::~Widget() {
+    if (compositor)
+        compositor->remove(*this);
+}
+
+inline void Widget::present() {
+    if (compositor) {
+        dirty               = true;
+        compositor->pending = true;
+    } else {
+        stage();
+        doupdate();
+    }
+}
+
+inline void Widget::presentFrame() {
+    present();
+    if (compositor)
+        compositor->waitFrame();
+}
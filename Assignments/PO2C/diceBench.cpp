@@ -0,0 +1,114 @@
+#include "compositorClass.hpp"  // one doupdate per frame
+#include "diceClass.hpp"        // DiceViz and DiceBatch
+#include <chrono>               // timing
+#include <cstdio>               // printf, tmpfile
+#include <cstdlib>              // strtoul, srand
+#include <memory>               // unique_ptr
+#include <ncurses.h>            // Ncurses library
+#include <vector>               // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Dice Rendering Benchmark
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Draws a screen of dice frame after frame, first as one DiceViz per
+*        die (a window and a refresh each), then as the same DiceViz windows
+*        added to a Compositor (staged, one doupdate per frame), and then as
+*        one DiceBatch (one pad, one refresh per frame). The terminal is a
+*        temporary file, so nothing shows; prints the time per frame, the
+*        bytes that would have gone to the terminal per frame and how many
+*        times per frame the terminal was written to.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o diceBench diceBench.cpp -lncurses`
+*        - Run with `./diceBench [dice] [frames]` (at most 40 dice fit the 80x24 screen)
+*
+*  Files:             diceBench.cpp       : benchmark driver
+*                     diceClass.hpp       : the dice renderers
+*                     compositorClass.hpp : widgets drawn in one update per frame
+*****************************************************************************/
+
+const int perRow = 10;  // 10 dice, 1 column apart, fill 79 columns
+
+void report(const char *name, double secs, long bytes, long updates, int frames) {
+    std::printf("%-10s %9.1f us/frame  %8.1f bytes/frame  %5.1f updates/frame\n", name, secs * 1e6 / frames,
+                static_cast<double>(bytes) / frames, static_cast<double>(updates) / frames);
+}
+
+int main(int argc, char **argv) {
+    int dice   = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 40;
+    int frames = argc > 2 ? static_cast<int>(std::strtoul(argv[2], nullptr, 10)) : 2000;
+    dice       = dice < 1 ? 1 : dice > 40 ? 40 : dice;
+
+    FILE *terminal = std::tmpfile();
+    SCREEN *screen = newterm("xterm", terminal, stdin);
+    if (!screen) {
+        std::fprintf(stderr, "no xterm terminfo entry\n");
+        return 1;
+    }
+    set_term(screen);
+    Logger::setLevel(Logger::Level::Off);  // time the drawing, not the logging
+    std::srand(1);
+
+    // one window per die
+    std::vector<std::unique_ptr<DiceViz> > single;
+    for (int i = 0; i < dice; ++i)
+        single.emplace_back(new DiceViz((i / perRow) * DiceViz::height, (i % perRow) * (DiceViz::width + 1)));
+    long before = std::ftell(terminal);
+    auto start  = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (auto &die : single)
+            die->draw_dice(std::rand() % 6 + 1);
+    }
+    double singleSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fflush(terminal);
+    long singleBytes = std::ftell(terminal) - before;
+
+    // the same windows, staged and written in one doupdate per frame
+    Compositor compositor(0);  // no frame cap, time the drawing
+    for (auto &die : single)
+        compositor.add(*die);
+    compositor.frame();
+    before = std::ftell(terminal);
+    start  = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (auto &die : single)
+            die->draw_dice(std::rand() % 6 + 1);
+        compositor.frame();
+    }
+    double composedSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fflush(terminal);
+    long composedBytes   = std::ftell(terminal) - before;
+    long composedUpdates = static_cast<long>(compositor.frames()) - 1;
+    single.clear();
+    clear();
+    refresh();
+
+    // one pad for all of them
+    DiceBatch batch(0, 0, dice, perRow);
+    before = std::ftell(terminal);
+    start  = std::chrono::steady_clock::now();
+    for (int f = 0; f < frames; ++f) {
+        for (int i = 0; i < dice; ++i)
+            batch.set(i, std::rand() % 6 + 1);
+        batch.draw();
+    }
+    double batchSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fflush(terminal);
+    long batchBytes = std::ftell(terminal) - before;
+
+    endwin();
+    delscreen(screen);
+    std::fclose(terminal);
+
+    std::printf("%d dice, %d frames\n", dice, frames);
+    report("DiceViz", singleSecs, singleBytes, static_cast<long>(dice) * frames, frames);
+    report("Composited", composedSecs, composedBytes, composedUpdates, frames);
+    report("DiceBatch", batchSecs, batchBytes, frames, frames);
+    return 0;
+}
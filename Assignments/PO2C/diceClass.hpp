@@ -3,103 +3,198 @@
 #include <ncurses.h>
 #include <unistd.h>  // For usleep()
 
+#include "compositorClass.hpp"
 #include "logger.hpp"
-#include <map>
-#include <string>
-#include <utility>
+#include "trace.hpp"
+#include <cstdint>
+#include <vector>
 
 using namespace std;
 
-class DiceViz {
+class DiceViz : public Widget {
     WINDOW *win;
     int border_color;
     int dot_color;
     int x;
     int y;
-    std::map<std::string, std::pair<int, int> > dot_pos;
     int last_dice_value;
 
    public:
+    static constexpr int height = 5;  // a die with its border
+    static constexpr int width  = 7;
+
+    // Where each pip can go inside a die: upper left, upper right, middle left, middle,
+    // middle right, lower left, lower right
+    struct Pip {
+        int y, x;
+    };
+    static constexpr Pip pips[7] = {{1, 1}, {1, 5}, {2, 1}, {2, 3}, {2, 5}, {3, 1}, {3, 5}};
+
+    // The pips shown for each face, pips[0] to pips[6] read left to right; face 0 is blank
+    static constexpr uint8_t faces[7] = {
+        0b0000000,  // 0
+        0b0001000,  // 1: middle
+        0b1000001,  // 2: upper left, lower right
+        0b1001001,  // 3: and the middle
+        0b1100011,  // 4: the corners
+        0b1101011,  // 5: the corners and the middle
+        0b1110111,  // 6: both sides
+    };
+
+    /**
+     * Draws a die showing `face` into `w` with its top left corner at
+     * (top, left), border and all, without refreshing. Anything inside the
+     * border is overwritten, so the previous face does not need clearing.
+     */
+    static void drawFace(WINDOW *w, int top, int left, int face, int border_color, int dot_color) {
+        wattron(w, COLOR_PAIR(border_color));
+        mvwaddch(w, top, left, ACS_ULCORNER);
+        mvwhline(w, top, left + 1, ACS_HLINE, width - 2);
+        mvwaddch(w, top, left + width - 1, ACS_URCORNER);
+        mvwvline(w, top + 1, left, ACS_VLINE, height - 2);
+        mvwvline(w, top + 1, left + width - 1, ACS_VLINE, height - 2);
+        mvwaddch(w, top + height - 1, left, ACS_LLCORNER);
+        mvwhline(w, top + height - 1, left + 1, ACS_HLINE, width - 2);
+        mvwaddch(w, top + height - 1, left + width - 1, ACS_LRCORNER);
+        wattroff(w, COLOR_PAIR(border_color));
+
+        for (int row = 1; row < height - 1; ++row)
+            mvwhline(w, top + row, left + 1, ' ', width - 2);
+        uint8_t mask = (face >= 1 && face <= 6) ? faces[face] : 0;
+        wattron(w, COLOR_PAIR(dot_color));
+        for (int i = 0; i < 7; ++i) {
+            if (mask & (1 << (6 - i)))
+                mvwaddstr(w, top + pips[i].y, left + pips[i].x, "●");
+        }
+        wattroff(w, COLOR_PAIR(dot_color));
+    }
+
     DiceViz(int y, int x) : y(y), x(x) {
-        win             = newwin(5, 7, y, x);
+        win             = newwin(height, width, y, x);
         border_color    = 1;
         dot_color       = 1;
         last_dice_value = 0;
-        // Add entries to the map
-        dot_pos["ul"] = std::make_pair(1, 1);  // Upper left
-        dot_pos["ur"] = std::make_pair(1, 5);  // Upper right
-        dot_pos["ml"] = std::make_pair(2, 1);  // Middle left
-        dot_pos["mm"] = std::make_pair(2, 3);  // Middle middle
-        dot_pos["mr"] = std::make_pair(2, 5);  // Middle right
-        dot_pos["ll"] = std::make_pair(3, 1);  // Lower left
-        dot_pos["lr"] = std::make_pair(3, 5);  // Lower right
     }
     void setBorderColor(int bcolor) { border_color = bcolor; }
     void setDotColor(int dcolor) { dot_color = dcolor; }
     void draw_dice(int number) {
-        // Draw the box around the dice
-
-        wattron(win, COLOR_PAIR(border_color));  // Turn on color pair 2
-        box(win, 0, 0);
-        wattroff(win, COLOR_PAIR(border_color));  // Turn off the color
-
-        wrefresh(win);
-
-        wattron(win, COLOR_PAIR(dot_color));  // Turn on color pair 2
-
-        // Print dots based on the number on the dice
-        switch (number) {
-            case 1:
-                mvwprintw(win, dot_pos["mm"].first, dot_pos["mm"].second, "●");
-                break;
-            case 2:
-                mvwprintw(win, dot_pos["ul"].first, dot_pos["ul"].second, "●");
-                mvwprintw(win, dot_pos["lr"].first, dot_pos["lr"].second, "●");
-                break;
-            case 3:
-                mvwprintw(win, dot_pos["ul"].first, dot_pos["ul"].second, "●");
-                mvwprintw(win, dot_pos["mm"].first, dot_pos["mm"].second, "●");
-                mvwprintw(win, dot_pos["lr"].first, dot_pos["lr"].second, "●");
-                break;
-            case 4:
-                mvwprintw(win, dot_pos["ul"].first, dot_pos["ul"].second, "●");
-                mvwprintw(win, dot_pos["ur"].first, dot_pos["ur"].second, "●");
-                mvwprintw(win, dot_pos["lr"].first, dot_pos["lr"].second, "●");
-                mvwprintw(win, dot_pos["ll"].first, dot_pos["ll"].second, "●");
-                break;
-            case 5:
-                mvwprintw(win, dot_pos["ul"].first, dot_pos["ul"].second, "●");
-                mvwprintw(win, dot_pos["ur"].first, dot_pos["ur"].second, "●");
-                mvwprintw(win, dot_pos["lr"].first, dot_pos["lr"].second, "●");
-                mvwprintw(win, dot_pos["ll"].first, dot_pos["ll"].second, "●");
-                mvwprintw(win, dot_pos["mm"].first, dot_pos["mm"].second, "●");
-                break;
-            case 6:
-                mvwprintw(win, dot_pos["ul"].first, dot_pos["ul"].second, "●");
-                mvwprintw(win, dot_pos["ur"].first, dot_pos["ur"].second, "●");
-                mvwprintw(win, dot_pos["lr"].first, dot_pos["lr"].second, "●");
-                mvwprintw(win, dot_pos["ll"].first, dot_pos["ll"].second, "●");
-                mvwprintw(win, dot_pos["ml"].first, dot_pos["ml"].second, "●");
-                mvwprintw(win, dot_pos["mr"].first, dot_pos["mr"].second, "●");
-                break;
-        }
-        wattroff(win, COLOR_PAIR(dot_color));  // Turn off the color
-        wrefresh(win);
-        // delwin(win);
+        drawFace(win, 0, 0, number, border_color, dot_color);
+        present();
     }
-    void refresh() { wrefresh(win); }
-    void clear() { wclear(win); }
+    void stage() override { wnoutrefresh(win); }
+    void refresh() { present(); }
+    // werase, not wclear: wclear makes the next refresh repaint the whole terminal
+    void clear() { werase(win); }
     int getLastDiceValue() { return last_dice_value; }
     void animate_dice(int refresh_count, int sleep_amnt = 100000) {
+        static const Logger::Site animate("DiceViz::animate_dice", LogFormat::Span);
+        static const Logger::Site frame("DiceViz::draw_dice", LogFormat::Span);
+        Trace::Span span(animate);
         // Shuffle dice faces for a set amount of time
         for (int i = 0; i < refresh_count; ++i) {
             last_dice_value = (rand() % 6 + 1);  // Random number between 1 and 6
             // No need to clear the whole screen, just refresh the dice window
-            draw_dice(last_dice_value);
-            Logger::log("Dice Value", to_string(last_dice_value));
+            {
+                Trace::Span drawing(frame);
+                drawFace(win, 0, 0, last_dice_value, border_color, dot_color);
+            }
+            presentFrame();
+            static const Logger::Site diceValue("Dice Value");
+            Logger::log<Logger::Level::Debug>(diceValue, last_dice_value);
             Logger::printLastLine(stdscr);
             usleep(sleep_amnt);  // 100ms delay for visual effect
-            clear();
         }
+        // each frame overwrites the last, so the window is only cleared at the end
+        clear();
+    }
+};
+
+/**
+ * DiceBatch
+ *
+ * Description:
+ *      Any number of dice drawn together: every die is drawn into one
+ *      off-screen pad and the pad is copied to the screen with a single
+ *      refresh, however many dice there are. Dice are laid out `per_row` to
+ *      a row, `gap` columns apart. For a dashboard of many dice where one
+ *      DiceViz each would mean a window and a terminal write per die.
+ *      Like DiceViz it is a Widget and can be drawn as part of a Compositor
+ *      frame.
+ *
+ * Public Methods:
+ *      - DiceBatch(int y, int x, int count, int per_row, int gap = 1)
+ *      - int size() const
+ *      - void set(int index, int face) / int get(int index) const
+ *      - void setColors(int border, int dot)
+ *      - void draw()                        : Draws every die and presents the pad once.
+ *      - void animate_dice(int refresh_count, int sleep_amnt = 100000)
+ *
+ * Usage:
+ *      DiceBatch dice(2, 0, 24, 8);         // 24 dice, 8 to a row, at row 2
+ *      dice.animate_dice(10, 50000);        // each frame is one refresh
+ *      dice.set(0, 6);
+ *      dice.draw();
+ */
+class DiceBatch : public Widget {
+   public:
+    DiceBatch(int y, int x, int count, int per_row, int gap = 1)
+        : y(y), x(x), per_row(per_row > 0 ? per_row : 1), gap(gap), faces(count > 0 ? count : 0, 0) {
+        int rows = (size() + this->per_row - 1) / this->per_row;
+        int cols = size() < this->per_row ? size() : this->per_row;
+        pad_height = rows > 0 ? rows * DiceViz::height : 1;
+        pad_width  = cols > 0 ? cols * (DiceViz::width + gap) - gap : 1;
+        pad        = newpad(pad_height, pad_width);
     }
+    ~DiceBatch() { delwin(pad); }
+
+    DiceBatch(const DiceBatch &)            = delete;
+    DiceBatch &operator=(const DiceBatch &) = delete;
+
+    int size() const { return static_cast<int>(faces.size()); }
+    void set(int index, int face) { faces[index] = face; }
+    int get(int index) const { return faces[index]; }
+
+    void setColors(int border, int dot) {
+        border_color = border;
+        dot_color    = dot;
+    }
+
+    void draw() {
+        drawPad();
+        present();
+    }
+
+    void stage() override { pnoutrefresh(pad, 0, 0, y, x, y + pad_height - 1, x + pad_width - 1); }
+
+    void animate_dice(int refresh_count, int sleep_amnt = 100000) {
+        static const Logger::Site animate("DiceBatch::animate_dice", LogFormat::Span);
+        static const Logger::Site frame("DiceBatch::draw", LogFormat::Span);
+        Trace::Span span(animate);
+        for (int i = 0; i < refresh_count; ++i) {
+            for (int &face : faces)
+                face = rand() % 6 + 1;
+            {
+                Trace::Span drawing(frame);
+                drawPad();
+            }
+            presentFrame();
+            usleep(sleep_amnt);
+        }
+    }
+
+   private:
+    void drawPad() {
+        for (int i = 0; i < size(); ++i) {
+            DiceViz::drawFace(pad, (i / per_row) * DiceViz::height, (i % per_row) * (DiceViz::width + gap), faces[i],
+                              border_color, dot_color);
+        }
+    }
+
+    int y, x;              // screen position of the first die
+    int per_row, gap;      // layout
+    int pad_height, pad_width;
+    int border_color = 1;
+    int dot_color    = 1;
+    std::vector<int> faces;  // face shown by each die, 0 for blank
+    WINDOW *pad;
 };
\ No newline at end of file
@@ -0,0 +1,488 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * WideInt
+ *
+ * Description:
+ *      Signed integer of any size, stored as a sign and a magnitude of 32-bit
+ *      limbs (least significant first, no leading zero limbs, so zero is an
+ *      empty magnitude and every value has exactly one representation).
+ *      Division truncates toward zero like the built-in types, which is all
+ *      BasicFraction needs to reduce.
+ *
+ * Public Methods:
+ *      - WideInt(long long value = 0)
+ *      - Arithmetic : + - * / % (and the compound forms), unary -
+ *      - Comparison : == != < > <= >=
+ *      - bool is_zero() const / bool negative() const
+ *      - double to_double() const
+ *      - std::string to_string() const
+ *
+ * Usage:
+ *      WideInt a = 1;
+ *      for (int i = 0; i < 40; ++i) a *= 6;   // 6^40, past 64 bits
+ *      std::cout << a % 1000000007 << std::endl;
+ */
+class WideInt {
+   public:
+    WideInt(long long value = 0) {
+        neg           = value < 0;
+        uint64_t magn = neg ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+        while (magn) {
+            mag.push_back(static_cast<uint32_t>(magn));
+            magn >>= 32;
+        }
+    }
+
+    bool is_zero() const { return mag.empty(); }
+    bool negative() const { return neg; }
+
+    WideInt operator-() const {
+        WideInt r = *this;
+        r.neg     = !r.is_zero() && !neg;
+        return r;
+    }
+
+    WideInt operator+(const WideInt &o) const {
+        if (neg == o.neg)
+            return make(neg, add_mag(mag, o.mag));
+        // different signs: subtract the smaller magnitude from the larger
+        int c = compare_mag(mag, o.mag);
+        if (c == 0)
+            return WideInt();
+        return c > 0 ? make(neg, sub_mag(mag, o.mag)) : make(o.neg, sub_mag(o.mag, mag));
+    }
+
+    WideInt operator-(const WideInt &o) const { return *this + (-o); }
+    WideInt operator*(const WideInt &o) const { return make(neg != o.neg, mul_mag(mag, o.mag)); }
+
+    WideInt operator/(const WideInt &o) const {
+        std::vector<uint32_t> q, r;
+        divmod_mag(mag, o.mag, q, r);
+        return make(neg != o.neg, std::move(q));
+    }
+
+    WideInt operator%(const WideInt &o) const {
+        std::vector<uint32_t> q, r;
+        divmod_mag(mag, o.mag, q, r);
+        return make(neg, std::move(r));
+    }
+
+    WideInt &operator+=(const WideInt &o) { return *this = *this + o; }
+    WideInt &operator-=(const WideInt &o) { return *this = *this - o; }
+    WideInt &operator*=(const WideInt &o) { return *this = *this * o; }
+    WideInt &operator/=(const WideInt &o) { return *this = *this / o; }
+    WideInt &operator%=(const WideInt &o) { return *this = *this % o; }
+
+    bool operator==(const WideInt &o) const { return neg == o.neg && mag == o.mag; }
+    bool operator!=(const WideInt &o) const { return !(*this == o); }
+    bool operator<(const WideInt &o) const { return compare(o) < 0; }
+    bool operator>(const WideInt &o) const { return compare(o) > 0; }
+    bool operator<=(const WideInt &o) const { return compare(o) <= 0; }
+    bool operator>=(const WideInt &o) const { return compare(o) >= 0; }
+
+    double to_double() const {
+        double r = 0.0;
+        for (size_t i = mag.size(); i-- > 0;)
+            r = r * 4294967296.0 + mag[i];
+        return neg ? -r : r;
+    }
+
+    std::string to_string() const {
+        if (is_zero())
+            return "0";
+        // peel off nine decimal digits at a time
+        std::vector<uint32_t> rest = mag;
+        std::string out;
+        while (!rest.empty()) {
+            uint64_t rem = 0;
+            for (size_t i = rest.size(); i-- > 0;) {
+                uint64_t cur = (rem << 32) | rest[i];
+                rest[i]      = static_cast<uint32_t>(cur / 1000000000u);
+                rem          = cur % 1000000000u;
+            }
+            trim(rest);
+            for (int d = 0; d < 9 && (rem || !rest.empty()); ++d) {
+                out += static_cast<char>('0' + rem % 10);
+                rem /= 10;
+            }
+        }
+        if (neg)
+            out += '-';
+        return std::string(out.rbegin(), out.rend());
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const WideInt &v) { return os << v.to_string(); }
+
+    // Lehmer's gcd (Knuth, algorithm L): most steps run on the leading 32 bits
+    // and are applied to the full numbers together, so long division is rare
+    static WideInt gcd(const WideInt &a, const WideInt &b) {
+        std::vector<uint32_t> u = a.mag, v = b.mag;
+        if (compare_mag(u, v) < 0)
+            std::swap(u, v);
+        while (!v.empty()) {
+            if (u.size() <= 2) {
+                uint64_t x = low64(u), y = low64(v);
+                while (y) {
+                    uint64_t t = x % y;
+                    x          = y;
+                    y          = t;
+                }
+                return make_u64(x);
+            }
+            size_t shift = bit_length(u) - 32;
+            int64_t uh = static_cast<int64_t>(window(u, shift)), vh = static_cast<int64_t>(window(v, shift));
+            int64_t A = 1, B = 0, C = 0, D = 1;
+            while (vh + C > 0 && vh + D > 0) {
+                int64_t q = (uh + A) / (vh + C);
+                if (q != (uh + B) / (vh + D))
+                    break;
+                int64_t t = A - q * C;
+                A         = C;
+                C         = t;
+                t         = B - q * D;
+                B         = D;
+                D         = t;
+                t         = uh - q * vh;
+                uh        = vh;
+                vh        = t;
+            }
+            if (B == 0) {
+                std::vector<uint32_t> q, r;
+                divmod_mag(u, v, q, r);
+                trim(r);
+                u.swap(v);
+                v.swap(r);
+            } else {
+                std::vector<uint32_t> nu = combine(u, v, A, B), nv = combine(u, v, C, D);
+                u.swap(nu);
+                v.swap(nv);
+            }
+        }
+        return make(false, std::move(u));
+    }
+
+   private:
+    bool neg = false;
+    std::vector<uint32_t> mag;
+
+    static WideInt make(bool negative, std::vector<uint32_t> &&m) {
+        WideInt r;
+        r.mag = std::move(m);
+        trim(r.mag);
+        r.neg = negative && !r.mag.empty();
+        return r;
+    }
+
+    static void trim(std::vector<uint32_t> &m) {
+        while (!m.empty() && m.back() == 0)
+            m.pop_back();
+    }
+
+    static uint64_t low64(const std::vector<uint32_t> &m) {
+        uint64_t r = 0;
+        for (size_t i = std::min<size_t>(m.size(), 2); i-- > 0;)
+            r = (r << 32) | m[i];
+        return r;
+    }
+
+    static WideInt make_u64(uint64_t x) {
+        std::vector<uint32_t> m = {static_cast<uint32_t>(x), static_cast<uint32_t>(x >> 32)};
+        return make(false, std::move(m));
+    }
+
+    static size_t bit_length(const std::vector<uint32_t> &m) {
+        size_t bits = 32 * m.size();
+        for (uint32_t top = m.back(); !(top & 0x80000000u); top <<= 1)
+            --bits;
+        return bits;
+    }
+
+    // The 32 bits of `m` starting at bit `shift`
+    static uint32_t window(const std::vector<uint32_t> &m, size_t shift) {
+        size_t limb = shift / 32, s = shift % 32;
+        if (limb >= m.size())
+            return 0;
+        uint64_t w = m[limb];
+        if (limb + 1 < m.size())
+            w |= static_cast<uint64_t>(m[limb + 1]) << 32;
+        return static_cast<uint32_t>(w >> s);
+    }
+
+    // x * u + y * v, which the caller knows is not negative
+    static std::vector<uint32_t> combine(const std::vector<uint32_t> &u, const std::vector<uint32_t> &v, int64_t x,
+                                         int64_t y) {
+        std::vector<uint32_t> r(std::max(u.size(), v.size()) + 1);
+        __int128 carry = 0;
+        for (size_t i = 0; i < r.size(); ++i) {
+            if (i < u.size())
+                carry += static_cast<__int128>(x) * u[i];
+            if (i < v.size())
+                carry += static_cast<__int128>(y) * v[i];
+            r[i] = static_cast<uint32_t>(static_cast<uint64_t>(carry) & 0xFFFFFFFFu);
+            carry >>= 32;
+        }
+        trim(r);
+        return r;
+    }
+
+    int compare(const WideInt &o) const {
+        if (neg != o.neg)
+            return neg ? -1 : 1;
+        int c = compare_mag(mag, o.mag);
+        return neg ? -c : c;
+    }
+
+    static int compare_mag(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+        if (a.size() != b.size())
+            return a.size() < b.size() ? -1 : 1;
+        for (size_t i = a.size(); i-- > 0;) {
+            if (a[i] != b[i])
+                return a[i] < b[i] ? -1 : 1;
+        }
+        return 0;
+    }
+
+    static std::vector<uint32_t> add_mag(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+        const std::vector<uint32_t> &big = a.size() >= b.size() ? a : b;
+        const std::vector<uint32_t> &sml = a.size() >= b.size() ? b : a;
+        std::vector<uint32_t> r(big.size() + 1);
+        uint64_t carry = 0;
+        for (size_t i = 0; i < big.size(); ++i) {
+            uint64_t t = carry + big[i] + (i < sml.size() ? sml[i] : 0);
+            r[i]       = static_cast<uint32_t>(t);
+            carry      = t >> 32;
+        }
+        r[big.size()] = static_cast<uint32_t>(carry);
+        return r;
+    }
+
+    // a - b for |a| >= |b|
+    static std::vector<uint32_t> sub_mag(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+        std::vector<uint32_t> r(a.size());
+        int64_t borrow = 0;
+        for (size_t i = 0; i < a.size(); ++i) {
+            int64_t t = static_cast<int64_t>(a[i]) - borrow - (i < b.size() ? b[i] : 0);
+            borrow    = t < 0;
+            r[i]      = static_cast<uint32_t>(t + (borrow << 32));
+        }
+        return r;
+    }
+
+    static std::vector<uint32_t> mul_mag(const std::vector<uint32_t> &a, const std::vector<uint32_t> &b) {
+        if (a.empty() || b.empty())
+            return {};
+        std::vector<uint32_t> r(a.size() + b.size());
+        for (size_t i = 0; i < a.size(); ++i) {
+            uint64_t carry = 0;
+            for (size_t j = 0; j < b.size(); ++j) {
+                uint64_t t = static_cast<uint64_t>(a[i]) * b[j] + r[i + j] + carry;
+                r[i + j]   = static_cast<uint32_t>(t);
+                carry      = t >> 32;
+            }
+            r[i + b.size()] = static_cast<uint32_t>(carry);
+        }
+        return r;
+    }
+
+    // Long division (Knuth, algorithm D) of magnitudes; q and r come back untrimmed
+    static void divmod_mag(const std::vector<uint32_t> &u, const std::vector<uint32_t> &v, std::vector<uint32_t> &q,
+                           std::vector<uint32_t> &r) {
+        if (v.empty())
+            throw std::domain_error("WideInt division by zero");
+        if (compare_mag(u, v) < 0) {
+            q.clear();
+            r = u;
+            return;
+        }
+        const size_t n = v.size(), m = u.size();
+        q.assign(m - n + 1, 0);
+        if (n == 1) {
+            uint64_t rem = 0;
+            for (size_t i = m; i-- > 0;) {
+                uint64_t cur = (rem << 32) | u[i];
+                q[i]         = static_cast<uint32_t>(cur / v[0]);
+                rem          = cur % v[0];
+            }
+            r.assign(1, static_cast<uint32_t>(rem));
+            return;
+        }
+        // shift so the divisor's top limb has its high bit set
+        int s = 0;
+        while (!(v[n - 1] & (0x80000000u >> s)))
+            ++s;
+        std::vector<uint32_t> vn(n), un(m + 1);
+        for (size_t i = n - 1; i > 0; --i)
+            vn[i] = (v[i] << s) | (s ? v[i - 1] >> (32 - s) : 0);
+        vn[0] = v[0] << s;
+        un[m] = s ? u[m - 1] >> (32 - s) : 0;
+        for (size_t i = m - 1; i > 0; --i)
+            un[i] = (u[i] << s) | (s ? u[i - 1] >> (32 - s) : 0);
+        un[0] = u[0] << s;
+
+        const uint64_t base = uint64_t(1) << 32;
+        for (size_t j = m - n + 1; j-- > 0;) {
+            // estimate the quotient limb from the top two limbs, then correct it
+            uint64_t num  = (static_cast<uint64_t>(un[j + n]) << 32) | un[j + n - 1];
+            uint64_t qhat = num / vn[n - 1];
+            uint64_t rhat = num % vn[n - 1];
+            while (qhat >= base || qhat * vn[n - 2] > ((rhat << 32) | un[j + n - 2])) {
+                --qhat;
+                rhat += vn[n - 1];
+                if (rhat >= base)
+                    break;
+            }
+            int64_t borrow = 0, t = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t p = qhat * vn[i];
+                t          = static_cast<int64_t>(un[i + j]) - borrow - static_cast<int64_t>(p & 0xFFFFFFFFu);
+                un[i + j]  = static_cast<uint32_t>(t);
+                borrow     = static_cast<int64_t>(p >> 32) - (t >> 32);
+            }
+            t         = static_cast<int64_t>(un[j + n]) - borrow;
+            un[j + n] = static_cast<uint32_t>(t);
+            q[j]      = static_cast<uint32_t>(qhat);
+            if (t < 0) {
+                // estimate was one too large: add the divisor back
+                --q[j];
+                uint64_t carry = 0;
+                for (size_t i = 0; i < n; ++i) {
+                    uint64_t sum = static_cast<uint64_t>(un[i + j]) + vn[i] + carry;
+                    un[i + j]    = static_cast<uint32_t>(sum);
+                    carry        = sum >> 32;
+                }
+                un[j + n] += static_cast<uint32_t>(carry);
+            }
+        }
+        r.assign(n, 0);
+        for (size_t i = 0; i < n; ++i)
+            r[i] = (un[i] >> s) | (s ? un[i + 1] << (32 - s) : 0);
+    }
+};
+
+/**
+ * BasicFraction
+ *
+ * Description:
+ *      The Fraction class from PO1 with the integer type as a template
+ *      parameter, so the same reduced numerator / denominator arithmetic runs
+ *      on built-in integers or on WideInt when the denominators outgrow 64
+ *      bits. As in PO1 every result is reduced and the sign kept on the
+ *      numerator, so equal values are equal member by member. Ordering is
+ *      added for picking the best of several exact values.
+ *
+ * Public Methods:
+ *      - BasicFraction(Int num = 0, Int den = 1) : Throws std::invalid_argument on a zero denominator.
+ *      - Arithmetic : + - * / (and += -= *= /=)
+ *      - Comparison : == != < > <= >=
+ *      - const Int& numerator() const / const Int& denominator() const
+ *      - double to_double() const
+ *
+ * Usage:
+ *      Fraction sixth(1, 6);
+ *      Fraction p = sixth * Fraction(5) + sixth;   // 1/1
+ *      std::cout << p << std::endl;
+ */
+template <typename Int>
+class BasicFraction {
+   public:
+    BasicFraction(Int num = 0, Int den = 1) : num(num), den(den) {
+        if (den == Int(0))
+            throw std::invalid_argument("Denominator cannot be zero.");
+        reduce();
+    }
+
+    const Int &numerator() const { return num; }
+    const Int &denominator() const { return den; }
+
+    BasicFraction operator+(const BasicFraction &other) const {
+        Int common = lcm(den, other.den);
+        return BasicFraction(num * (common / den) + other.num * (common / other.den), common);
+    }
+
+    BasicFraction operator-(const BasicFraction &other) const {
+        Int common = lcm(den, other.den);
+        return BasicFraction(num * (common / den) - other.num * (common / other.den), common);
+    }
+
+    BasicFraction operator*(const BasicFraction &other) const {
+        return BasicFraction(num * other.num, den * other.den);
+    }
+
+    BasicFraction operator/(const BasicFraction &other) const {
+        return BasicFraction(num * other.den, den * other.num);
+    }
+
+    BasicFraction &operator+=(const BasicFraction &other) { return *this = *this + other; }
+    BasicFraction &operator-=(const BasicFraction &other) { return *this = *this - other; }
+    BasicFraction &operator*=(const BasicFraction &other) { return *this = *this * other; }
+    BasicFraction &operator/=(const BasicFraction &other) { return *this = *this / other; }
+
+    bool operator==(const BasicFraction &other) const { return num == other.num && den == other.den; }
+    bool operator!=(const BasicFraction &other) const { return !(*this == other); }
+    // denominators are positive, so cross-multiplying keeps the order
+    bool operator<(const BasicFraction &other) const { return num * other.den < other.num * den; }
+    bool operator>(const BasicFraction &other) const { return other < *this; }
+    bool operator<=(const BasicFraction &other) const { return !(other < *this); }
+    bool operator>=(const BasicFraction &other) const { return !(*this < other); }
+
+    double to_double() const {
+        if constexpr (std::is_same<Int, WideInt>::value) {
+            // scale first so huge numerators and denominators do not overflow a double
+            WideInt scale(1ll << 60);
+            return (num * scale / den).to_double() / scale.to_double();
+        } else {
+            return static_cast<double>(num) / static_cast<double>(den);
+        }
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const BasicFraction &frac) {
+        os << frac.num << "/" << frac.den;
+        return os;
+    }
+
+   private:
+    Int num;  // The numerator of the fraction, carries the sign
+    Int den;  // The denominator of the fraction, always positive
+
+    static Int gcd(Int a, Int b) {
+        if constexpr (std::is_same<Int, WideInt>::value)
+            return WideInt::gcd(a, b);
+        if (a < Int(0))
+            a = -a;
+        if (b < Int(0))
+            b = -b;
+        while (!(b == Int(0))) {
+            Int temp = b;
+            b        = a % b;
+            a        = temp;
+        }
+        return a;
+    }
+
+    static Int lcm(const Int &a, const Int &b) { return a / gcd(a, b) * b; }
+
+    void reduce() {
+        Int divisor = gcd(num, den);
+        if (!(divisor == Int(1))) {
+            num /= divisor;
+            den /= divisor;
+        }
+        if (den < Int(0)) {
+            num = -num;
+            den = -den;
+        }
+    }
+};
+
+using Fraction = BasicFraction<WideInt>;
@@ -1,13 +1,47 @@
 #pragma once
 
 #include <ncurses.h>
+#include "compositorClass.hpp"
 #include "logger.hpp"
+#include "trace.hpp"
 #include <ctime>
 #include <string>
 
 using namespace std;
 
-class Grid {
+/**
+ * BasicGrid
+ *
+ * Description:
+ *      Ncurses view of one Knucklebones board with `Rows` x `Cols` cells. The
+ *      sizes are template parameters so the drawing loops have constant
+ *      bounds; `Grid` is the standard 3x3 board. A Widget, so it can be drawn
+ *      as part of a Compositor frame.
+ *
+ *      Placing or removing a value redraws only that cell's text: the cell
+ *      is marked changed and `update()` rewrites the changed cells, so a
+ *      move sends a few bytes to the terminal rather than the whole board.
+ *      The borders are drawn again only when the colors change or after
+ *      `invalidate()` (a terminal resize).
+ *
+ * Public Methods:
+ *      - void setValue(int row, int col, int value) / void removeValue(int row, int col)
+ *      - int getValue(int row, int col) const
+ *      - void addValue(int click_y, int click_x, int value) : Drops a value into the clicked column.
+ *      - void setColors(int border, int number)             : Redraws everything in the new colors.
+ *      - void invalidate()                                  : Everything is redrawn on the next update.
+ *      - void update()                                      : Draws what changed.
+ *      - void drawGrid() / void refreshGrid()               : Draws everything.
+ *
+ * Usage:
+ *      Grid grid(2, 10);
+ *      grid.addValue(y, x, 4);     // redraws one cell
+ *      grid.removeValue(2, 0);     // so does this
+ *      if (getch() == KEY_RESIZE)
+ *          grid.refreshGrid();
+ */
+template <int Rows = 3, int Cols = 3>
+class BasicGrid : public Widget {
    private:
     int start_y, start_x;
     int cell_width, cell_height;
@@ -16,81 +50,138 @@ class Grid {
     int border_color = 1;
     int number_color = 2;
     WINDOW *win;
-    int values[3][3] = {{0, 0, 0}, {0, 0, 0}, {0, 0, 0}};
+    int values[Rows][Cols] = {};
+    bool changed[Rows][Cols] = {};  // cells whose value is not on screen yet
+    bool stale = false;             // borders and every cell need drawing
+
+    static void logPosition(int y, int x) {
+        static const Logger::Site position("yx", LogFormat::List);
+        Logger::log<Logger::Level::Debug>(position, y, x);
+    }
 
     void init() {
-        Logger::log("Initializing grid", "true");
+        Logger::log<Logger::Level::Debug>("Initializing grid", "true");
         cell_height = 1;
         cell_width  = 3;
-        height      = 3 * (cell_height + 1) + 1;
-        width       = 3 * (cell_width + 1) + 1;
+        height      = Rows * (cell_height + 1) + 1;
+        width       = Cols * (cell_width + 1) + 1;
         win         = newwin(height + 2, width + 2, start_y, start_x);
         base_y      = 1;
         base_x      = 1;
 
-        Logger::log("height", vector<int>({height, width, cell_height, cell_width}));
+        static const Logger::Site sizes("height", LogFormat::List);
+        Logger::log<Logger::Level::Debug>(sizes, height, width, cell_height, cell_width);
         drawGrid();
     }
 
    public:
-    Grid(int y = 0, int x = 0) : start_y(y), start_x(x) {
-        Logger::log("yx", vector<string>{to_string(y), to_string(x)});
+    BasicGrid(int y = 0, int x = 0) : start_y(y), start_x(x) {
+        logPosition(y, x);
         init();
     }
 
-    Grid(int y = 0, int x = 0, int b=1, int n=2) : start_y(y), start_x(x),border_color(b),number_color(n) {
-        Logger::log("yx", vector<string>{to_string(y), to_string(x)});
+    BasicGrid(int y = 0, int x = 0, int b=1, int n=2) : start_y(y), start_x(x),border_color(b),number_color(n) {
+        logPosition(y, x);
         init();
     }
 
     void drawGrid() {
+        static const Logger::Site draw("Grid::drawGrid", LogFormat::Span);
+        Trace::Span span(draw);
         wattron(win, COLOR_PAIR(border_color));  // Turn on color pair 2
-        mvwhline(win, ((base_y + cell_height) * 0) + 1, base_x + 1, ACS_HLINE, width - 2);
-        mvwhline(win, ((base_y + cell_height) * 1) + 1, base_x + 1, ACS_HLINE, width - 2);
-        mvwhline(win, ((base_y + cell_height) * 2) + 1, base_x + 1, ACS_HLINE, width - 2);
-        mvwhline(win, ((base_y + cell_height) * 3) + 1, base_x + 1, ACS_HLINE, width - 2);
-
-        mvwvline(win, base_y + 1, ((base_x + cell_width) * 0) + 1, ACS_VLINE, height - 2);
-        mvwvline(win, base_y + 1, ((base_x + cell_width) * 1) + 1, ACS_VLINE, height - 2);
-        mvwvline(win, base_y + 1, ((base_x + cell_width) * 2) + 1, ACS_VLINE, height - 2);
-        mvwvline(win, base_y + 1, ((base_x + cell_width) * 3) + 1, ACS_VLINE, height - 2);
+        for (int r = 0; r <= Rows; r++) {
+            mvwhline(win, ((base_y + cell_height) * r) + 1, base_x + 1, ACS_HLINE, width - 2);
+        }
+        for (int c = 0; c <= Cols; c++) {
+            mvwvline(win, base_y + 1, ((base_x + cell_width) * c) + 1, ACS_VLINE, height - 2);
+        }
 
         mvwaddch(win, base_y, base_x, ACS_ULCORNER);
         mvwaddch(win, base_y, base_x + width - 1, ACS_URCORNER);
         mvwaddch(win, base_y + height - 1, base_x, ACS_LLCORNER);
         mvwaddch(win, base_y + height - 1, base_x + width - 1, ACS_LRCORNER);
 
-        mvwaddch(win, ((base_y + cell_height) * 1) + 1, base_x, ACS_LTEE);
-        mvwaddch(win, ((base_y + cell_height) * 2) + 1, base_x, ACS_LTEE);
-        mvwaddch(win, ((base_y + cell_height) * 1) + 1, base_x + width - 1, ACS_RTEE);
-        mvwaddch(win, ((base_y + cell_height) * 2) + 1, base_x + width - 1, ACS_RTEE);
+        for (int r = 1; r < Rows; r++) {
+            mvwaddch(win, ((base_y + cell_height) * r) + 1, base_x, ACS_LTEE);
+            mvwaddch(win, ((base_y + cell_height) * r) + 1, base_x + width - 1, ACS_RTEE);
+        }
 
-        mvwaddch(win, base_y, ((base_x + cell_width) * 1) + 1, ACS_TTEE);
-        mvwaddch(win, base_y, ((base_x + cell_width) * 2) + 1, ACS_TTEE);
-        mvwaddch(win, base_y + height - 1, ((base_x + cell_width) * 1) + 1, ACS_BTEE);
-        mvwaddch(win, base_y + height - 1, ((base_x + cell_width) * 2) + 1, ACS_BTEE);
+        for (int c = 1; c < Cols; c++) {
+            mvwaddch(win, base_y, ((base_x + cell_width) * c) + 1, ACS_TTEE);
+            mvwaddch(win, base_y + height - 1, ((base_x + cell_width) * c) + 1, ACS_BTEE);
+        }
 
-        mvwaddch(win, ((base_y + cell_height) * 1) + 1, ((base_x + cell_width) * 1) + 1, ACS_PLUS);  // ACS_PLUS
-        mvwaddch(win, ((base_y + cell_height) * 1) + 1, ((base_x + cell_width) * 2) + 1, ACS_PLUS);  // ACS_PLUS
-        mvwaddch(win, ((base_y + cell_height) * 2) + 1, ((base_x + cell_width) * 1) + 1, ACS_PLUS);  // ACS_PLUS
-        mvwaddch(win, ((base_y + cell_height) * 2) + 1, ((base_x + cell_width) * 2) + 1, ACS_PLUS);  // ACS_PLUS
+        for (int r = 1; r < Rows; r++) {
+            for (int c = 1; c < Cols; c++) {
+                mvwaddch(win, ((base_y + cell_height) * r) + 1, ((base_x + cell_width) * c) + 1, ACS_PLUS);  // ACS_PLUS
+            }
+        }
         wattroff(win, COLOR_PAIR(border_color));
-        wattron(win, COLOR_PAIR(number_color));
         printValues();
-        wattroff(win, COLOR_PAIR(number_color));
-        wrefresh(win);
+        stale = false;
+        present();
     }
 
+    void stage() override { wnoutrefresh(win); }
+
     void printValues() {
-        for (int i = 0; i < 3; i++) {
-            for (int j = 0; j < 3; j++) {
-                int y = ((base_y + cell_height) * i) + 2;
-                int x = ((base_x + cell_width) * j) + 3;
-                if (values[i][j] > 0) {
-                    mvwprintw(win, y, x, to_string(values[i][j]).c_str());
+        for (int i = 0; i < Rows; i++) {
+            for (int j = 0; j < Cols; j++) {
+                drawCell(i, j);
+            }
+        }
+    }
+
+    // Blanks the inside of one cell and writes its value, if it has one
+    void drawCell(int row, int col) {
+        int y = ((base_y + cell_height) * row) + 2;
+        int x = ((base_x + cell_width) * col) + 2;
+        mvwhline(win, y, x, ' ', cell_width);
+        if (values[row][col] > 0) {
+            wattron(win, COLOR_PAIR(number_color));
+            mvwprintw(win, y, x + 1, "%d", values[row][col]);
+            wattroff(win, COLOR_PAIR(number_color));
+        }
+        changed[row][col] = false;
+    }
+
+    void setValue(int row, int col, int value) {
+        if (values[row][col] == value)
+            return;
+        values[row][col]  = value;
+        changed[row][col] = true;
+        update();
+    }
+
+    void removeValue(int row, int col) { setValue(row, col, 0); }
+
+    int getValue(int row, int col) const { return values[row][col]; }
+
+    void setColors(int border, int number) {
+        border_color = border;
+        number_color = number;
+        invalidate();
+        update();
+    }
+
+    void invalidate() { stale = true; }
+
+    void update() {
+        if (stale) {
+            refreshGrid();
+            return;
+        }
+        bool drew = false;
+        for (int i = 0; i < Rows; i++) {
+            for (int j = 0; j < Cols; j++) {
+                if (changed[i][j]) {
+                    drawCell(i, j);
+                    drew = true;
                 }
             }
         }
+        if (drew)
+            present();
     }
 
     /**
@@ -112,29 +203,28 @@ class Grid {
      * @return (int)            : The column number of the click event
      */
     int colClicked(int click_y, int click_x) {
-        int sx     = start_x;
-        int ex     = start_x + width;
-        int thirds = width / 3;
-
-        if (click_x < sx + thirds)
-            return 0;
-        else if (click_x < sx + 2 * thirds)
-            return 1;
-        else
-            return 2;
-        return 0;
+        int sx        = start_x;
+        int col_width = width / Cols;
+
+        for (int c = 0; c < Cols - 1; c++) {
+            if (click_x < sx + (c + 1) * col_width)
+                return c;
+        }
+        return Cols - 1;
     }
 
     void addValue(int click_y, int click_x, int value) {
         int col = colClicked(click_y, click_x);
-        Logger::log("colClicked", to_string(col).c_str());
-        int row          = availableRow(col);
-        values[row][col] = value;
-        refreshGrid();
+        static const Logger::Site clickedColumn("colClicked");
+        Logger::log<Logger::Level::Debug>(clickedColumn, col);
+        int row = availableRow(col);
+        if (row < 0)
+            return;  // the column is full
+        setValue(row, col, value);
     }
 
     int availableRow(int col) {
-        for (int i = 2; i >= 0; i--) {
+        for (int i = Rows - 1; i >= 0; i--) {
             if (values[i][col] == 0) {
                 return i;
             }
@@ -142,9 +232,12 @@ class Grid {
         return -1;
     }
 
+    // Everything from scratch; werase rather than wclear, which would repaint the whole terminal
     void refreshGrid() {
-        wclear(win);
+        werase(win);
         drawGrid();
     }
     WINDOW *getWindow() { return win; }
-};
\ No newline at end of file
+};
+
+using Grid = BasicGrid<3, 3>;
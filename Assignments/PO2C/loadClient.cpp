@@ -0,0 +1,251 @@
+#include "serverClass.hpp"  // wire protocol
+#include <algorithm>        // sort
+#include <chrono>           // timing
+#include <cstdlib>          // strtoul
+#include <deque>            // send timestamps
+#include <fstream>          // game id files
+#include <iostream>         // input/output
+#include <random>           // column choice
+#include <string>           // string data structure
+#include <thread>           // client threads
+#include <vector>           // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Load Client
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Load generator for the game server. Opens several connections, keeps
+*        a fixed number of games in flight on each, plays random legal moves
+*        and starts a new game whenever one ends. Every request is timed from
+*        the write that carried it to the read that returned its reply, and
+*        the run ends with moves/sec and latency percentiles.
+*
+*        Given a game id file it also tests snapshot recovery. At the end it
+*        keeps its connections, and so its unfinished games, open until the
+*        server is stopped (its final snapshot then holds them) and writes
+*        their ids to the file. A later run that finds the file first sends
+*        RESUME for each of those games, on whichever connections and so
+*        server loops they land, and plays them on alongside its new games.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o loadClient loadClient.cpp boardVariants.cpp`
+*        - Run with `./loadClient [socket_path] [games] [connections] [seconds] [id_file]`
+*        - e.g. `./loadClient /tmp/knucklebones.sock 10000 16 10`
+*        - Restore then resume, with the server on 4 loops:
+*            ./server /tmp/kb.sock 4 65536 games.snap &
+*            ./loadClient /tmp/kb.sock 10000 16 5 ids.txt &   (then, once it is waiting) kill -INT %1
+*            ./server /tmp/kb.sock 4 65536 games.snap &
+*            ./loadClient /tmp/kb.sock 10000 16 5 ids.txt     reports how many saved games it resumed
+*
+*  Files:             loadClient.cpp    : driver program for the load test
+*                     serverClass.hpp   : wire protocol shared with the server
+*****************************************************************************/
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * ClientStats
+ *
+ * Description:
+ *      What one connection measured: replies received and the latency of each,
+ *      how its RESUME requests went, and the games still going at the end.
+ */
+struct ClientStats {
+    uint64_t moves   = 0;
+    uint64_t games   = 0;
+    uint64_t resumed = 0;
+    uint64_t lost    = 0;  // RESUME answered with anything but ST_OK
+    std::vector<uint32_t> latency_ns;
+    std::vector<uint32_t> unfinished;
+};
+
+/**
+ * run_connection
+ *
+ * Description:
+ *      Plays `games` concurrent games over one connection until `deadline`,
+ *      then lets the outstanding replies drain. Games in `resume` are
+ *      claimed first and played too; a game that cannot be claimed is
+ *      replaced by a new one. With `hold` the connection then stays open
+ *      until the server closes it.
+ *
+ * Params:
+ *      const std::string& path : server socket
+ *      int games               : new games kept in flight
+ *      const std::vector<uint32_t>& resume : ids of restored games to claim
+ *      bool hold               : keep the games alive until the server stops
+ *      Clock::time_point deadline
+ *      ClientStats& stats      : filled with the results
+ *
+ * Returns:
+ *      void
+ */
+void run_connection(const std::string &path, int games, const std::vector<uint32_t> &resume, bool hold,
+                    Clock::time_point deadline, ClientStats &stats) {
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0) {
+        std::cerr << "Unable to connect to " << path << std::endl;
+        return;
+    }
+
+    std::mt19937 rng(static_cast<unsigned>(fd * 7919));
+    std::vector<MoveRequest> batch;
+    std::deque<Clock::time_point> sent;  // one entry per outstanding request, in order
+    std::vector<MoveReply> replies(4096);
+
+    auto send_batch = [&]() {
+        Clock::time_point now = Clock::now();
+        const char *data      = reinterpret_cast<const char *>(batch.data());
+        size_t left           = batch.size() * sizeof(MoveRequest);
+        while (left > 0) {
+            ssize_t n = write(fd, data, left);
+            if (n <= 0)
+                return false;
+            data += n;
+            left -= static_cast<size_t>(n);
+        }
+        sent.insert(sent.end(), batch.size(), now);
+        batch.clear();
+        return true;
+    };
+
+    for (uint32_t id : resume)
+        batch.push_back({OP_RESUME, 0, 0, id});
+    for (int i = 0; i < games; ++i)
+        batch.push_back({OP_NEW_GAME, 0, 0, 0});
+    bool ok             = send_batch();
+    size_t resumes_left = resume.size();  // the first replies answer the RESUMEs
+
+    size_t partial = 0;
+    while (ok && !sent.empty()) {
+        char *buf = reinterpret_cast<char *>(replies.data());
+        ssize_t n = read(fd, buf + partial, replies.size() * sizeof(MoveReply) - partial);
+        if (n <= 0)
+            break;
+        Clock::time_point now = Clock::now();
+        size_t total          = partial + static_cast<size_t>(n);
+        size_t count          = total / sizeof(MoveReply);
+        bool more             = now < deadline;
+
+        for (size_t i = 0; i < count; ++i) {
+            const MoveReply &rep = replies[i];
+            stats.latency_ns.push_back(static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now - sent.front()).count()));
+            sent.pop_front();
+            ++stats.moves;
+            if (resumes_left > 0) {
+                --resumes_left;
+                if (rep.status != ST_OK) {
+                    ++stats.lost;
+                    if (more)
+                        batch.push_back({OP_NEW_GAME, 0, 0, 0});
+                    continue;
+                }
+                ++stats.resumed;
+            }
+            if (!more) {
+                if (rep.status == ST_OK || rep.status == ST_ILLEGAL)
+                    stats.unfinished.push_back(rep.game_id);
+                continue;
+            }
+            if (rep.status == ST_GAME_OVER) {
+                ++stats.games;
+                batch.push_back({OP_NEW_GAME, 0, 0, 0});
+            } else if (rep.status == ST_OK || rep.status == ST_ILLEGAL) {
+                uint8_t cols[GameState::cols];
+                int legal = 0;
+                for (uint8_t col = 0; col < GameState::cols; ++col) {
+                    if (rep.legal & (1 << col))
+                        cols[legal++] = col;
+                }
+                batch.push_back({OP_MOVE, cols[rng() % legal], 0, rep.game_id});
+            }
+        }
+        partial = total - count * sizeof(MoveReply);
+        std::memmove(buf, buf + count * sizeof(MoveReply), partial);
+        if (!batch.empty())
+            ok = send_batch();
+    }
+    char byte;
+    while (hold && ok && read(fd, &byte, 1) > 0) {
+    }
+    close(fd);
+}
+
+int main(int argc, char **argv) {
+    std::string path    = argc > 1 ? argv[1] : "/tmp/knucklebones.sock";
+    int games           = argc > 2 ? static_cast<int>(std::strtoul(argv[2], nullptr, 10)) : 10000;
+    int connections     = argc > 3 ? static_cast<int>(std::strtoul(argv[3], nullptr, 10)) : 16;
+    int seconds         = argc > 4 ? static_cast<int>(std::strtoul(argv[4], nullptr, 10)) : 10;
+    std::string id_file = argc > 5 ? argv[5] : "";
+    if (connections < 1)
+        connections = 1;
+    // each connection writes before it reads, so it keeps no more in flight than the server buffers
+    int per_connection = static_cast<int>(GameServer::out_cap / sizeof(MoveReply)) / 2;
+    if (games > per_connection * connections) {
+        connections = (games + per_connection - 1) / per_connection;
+        std::cout << "using " << connections << " connections to keep " << games << " games in flight" << std::endl;
+    }
+
+    // games left over from the last run with this file, dealt round robin over the connections
+    std::vector<std::vector<uint32_t> > resume(connections);
+    size_t saved = 0;
+    if (!id_file.empty()) {
+        std::ifstream ids(id_file);
+        for (uint32_t id; ids >> id; ++saved)
+            resume[saved % connections].push_back(id);
+    }
+
+    std::vector<ClientStats> stats(connections);
+    std::vector<std::thread> threads;
+    Clock::time_point start    = Clock::now();
+    Clock::time_point deadline = start + std::chrono::seconds(seconds);
+    for (int i = 0; i < connections; ++i) {
+        int share = games / connections + (i < games % connections ? 1 : 0);
+        threads.emplace_back(run_connection, path, share, std::cref(resume[i]), !id_file.empty(), deadline,
+                             std::ref(stats[i]));
+    }
+    if (!id_file.empty()) {
+        std::this_thread::sleep_until(deadline);
+        std::cout << "holding the unfinished games until the server stops" << std::endl;
+    }
+    for (auto &t : threads)
+        t.join();
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+
+    uint64_t moves = 0, finished = 0, resumed = 0, lost = 0;
+    std::vector<uint32_t> all;
+    std::vector<uint32_t> unfinished;
+    for (auto &s : stats) {
+        moves += s.moves;
+        finished += s.games;
+        resumed += s.resumed;
+        lost += s.lost;
+        all.insert(all.end(), s.latency_ns.begin(), s.latency_ns.end());
+        unfinished.insert(unfinished.end(), s.unfinished.begin(), s.unfinished.end());
+    }
+    std::sort(all.begin(), all.end());
+    auto pct = [&](double p) { return all.empty() ? 0.0 : all[static_cast<size_t>(p * (all.size() - 1))] / 1000.0; };
+
+    std::cout << "games in flight: " << games << " over " << connections << " connection(s)" << std::endl;
+    std::cout << "requests: " << moves << " in " << elapsed << "s (" << static_cast<uint64_t>(moves / elapsed) << "/s)" << std::endl;
+    std::cout << "games finished: " << finished << std::endl;
+    if (saved > 0)
+        std::cout << "resumed " << resumed << " of " << saved << " saved games (" << lost << " not found)" << std::endl;
+    if (!id_file.empty()) {
+        std::ofstream ids(id_file, std::ios::trunc);
+        for (uint32_t id : unfinished)
+            ids << id << '\n';
+        std::cout << unfinished.size() << " unfinished game ids written to " << id_file << std::endl;
+    }
+    std::cout << "latency us p50 " << pct(0.50) << " p99 " << pct(0.99) << " p99.9 " << pct(0.999) << " max " << pct(1.0) << std::endl;
+    return 0;
+}
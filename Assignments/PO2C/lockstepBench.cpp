@@ -0,0 +1,131 @@
+#include "boardState.hpp"     // compact game state
+#include "lockstepClass.hpp"  // lockstep session
+#include "statsClass.hpp"     // latency histogram
+#include "strategyClass.hpp"  // players on both sides
+#include <chrono>             // timing
+#include <cstdio>             // printf
+#include <cstdlib>            // strtoul
+#include <string>             // string data structure
+#include <thread>             // stand-in peer
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Lockstep Latency Benchmark
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Plays games between two lockstep sessions, the host in a stand-in
+*        peer thread and the guest on the main thread, first over a Unix
+*        socket and then over TCP loopback. Prints the time from sending a
+*        move to receiving the reply (one network round trip plus the peer's
+*        move choice), moves per second, and any state hash mismatches.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o lockstepBench lockstepBench.cpp boardVariants.cpp`
+*        - Run with `./lockstepBench [games] [unix_path] [tcp_port]`
+*
+*  Files:             lockstepBench.cpp : benchmark driver
+*                     lockstepClass.hpp : lockstep protocol
+*****************************************************************************/
+
+struct SideResult {
+    Histogram reply_ns;  // send to the peer's next move arriving
+    uint64_t moves   = 0;
+    uint64_t desyncs = 0;
+    bool ok          = true;
+};
+
+/**
+ * play_side
+ *
+ * Description:
+ *      One side of `games` games over an open session. Both sides draw the
+ *      same dice, so they agree on every position without sending it.
+ */
+void play_side(LockstepSession &net, int games, SideResult &out) {
+    RandomStrategy player(static_cast<uint64_t>(net.seat()) + 11);
+    auto sent_at = std::chrono::steady_clock::now();
+    bool waiting = false;
+    for (int g = 0; g < games && out.ok; ++g) {
+        GameState s;
+        while (!s.is_over()) {
+            int roll = net.next_roll(GameState::sides);
+            if (s.turn == net.seat()) {
+                int col = player.choose(s, roll);
+                s.place(col, roll);
+                sent_at = std::chrono::steady_clock::now();
+                waiting = true;
+                if (!net.send_move(col, s.key())) {
+                    out.ok = false;
+                    break;
+                }
+            } else {
+                int col;
+                uint64_t hash;
+                if (!net.receive_move(col, hash)) {
+                    out.ok = false;
+                    break;
+                }
+                if (waiting) {
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - sent_at);
+                    out.reply_ns.record(static_cast<uint64_t>(ns.count()));
+                    waiting = false;
+                }
+                s.place(col, roll);
+                if (s.key() != hash)
+                    ++out.desyncs;
+            }
+            ++out.moves;
+        }
+    }
+}
+
+void run(const std::string &addr, int games) {
+    SideResult host_result, guest_result;
+    std::thread peer([&]() {
+        auto net = LockstepSession::host(addr, 0x5EEDull);
+        if (!net) {
+            host_result.ok = false;
+            return;
+        }
+        play_side(*net, games, host_result);
+    });
+
+    std::unique_ptr<LockstepSession> net;
+    for (int attempt = 0; attempt < 200 && !net; ++attempt) {
+        net = LockstepSession::join(addr);
+        if (!net)
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    if (!net) {
+        std::printf("%-22s could not connect\n", addr.c_str());
+        peer.join();
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    play_side(*net, games, guest_result);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    peer.join();
+    net.reset();
+
+    Histogram both = host_result.reply_ns;
+    both.merge(guest_result.reply_ns);
+    std::printf("%-22s %8.0f moves/s  reply us p50 %6.1f p99 %6.1f p99.9 %6.1f  desyncs %llu%s\n", addr.c_str(),
+                guest_result.moves / secs, both.percentile(50) / 1e3, both.percentile(99) / 1e3,
+                both.percentile(99.9) / 1e3,
+                static_cast<unsigned long long>(host_result.desyncs + guest_result.desyncs),
+                host_result.ok && guest_result.ok ? "" : "  (connection lost)");
+}
+
+int main(int argc, char **argv) {
+    int games             = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 2000;
+    std::string unix_path = argc > 2 ? argv[2] : "/tmp/knucklebones-lockstep.sock";
+    std::string port      = argc > 3 ? argv[3] : "47123";
+
+    run(unix_path, games);
+    run("127.0.0.1:" + port, games);
+    return 0;
+}
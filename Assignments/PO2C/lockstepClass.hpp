@@ -0,0 +1,246 @@
+#pragma once
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+
+/**
+ * LockstepSession
+ *
+ * Description:
+ *      Deterministic two-process play. Both sides run the same game code on
+ *      the same dice: the host picks a seed, sends it once in the handshake,
+ *      and from then on each side draws rolls from its own copy of the same
+ *      xorshift stream. The only thing sent per turn is the mover's column,
+ *      together with a hash of the mover's state after the move; the other
+ *      side applies the column, hashes its own state and compares, so a
+ *      desync is caught on the turn it happens. A turn is one 16-byte
+ *      message one way, with no acknowledgement round trip.
+ *
+ *      Addresses are either a Unix socket path or "host:port" for TCP (Nagle
+ *      is turned off so a lone move is not held back).
+ *
+ *      Message: {type, column, reserved, seq, hash}; HELLO carries the
+ *      protocol version in `column` and the seed in `hash`, MOVE carries the
+ *      move number in `seq`.
+ *
+ * Public Methods:
+ *      - static std::unique_ptr<LockstepSession> host(const std::string& addr, uint64_t seed)
+ *      - static std::unique_ptr<LockstepSession> join(const std::string& addr)
+ *      - int seat() const                     : 0 for the host, 1 for the guest.
+ *      - int next_roll(int sides)             : Next die, 1 to `sides`, from the shared stream.
+ *      - bool send_move(int column, uint64_t state_hash)
+ *      - bool receive_move(int& column, uint64_t& state_hash) : Blocks until the peer moves.
+ *      - int  poll_move(int& column, uint64_t& state_hash)    : 1 moved, 0 nothing yet, -1 closed.
+ *      - int fd() const                       : Socket, for callers with their own poll loop.
+ *
+ * Usage:
+ *      auto net = LockstepSession::host("/tmp/kb-duel.sock", seed);  // other side: join(...)
+ *      int roll = net->next_roll(GameState::sides);
+ *      if (my_turn) net->send_move(col, state.key());
+ *      else if (net->receive_move(col, hash) && apply(col), state.key() != hash) desync();
+ */
+class LockstepSession {
+   public:
+    enum Type : uint8_t { MSG_HELLO = 1, MSG_MOVE = 2, MSG_BYE = 3 };
+    static constexpr uint8_t version = 1;
+
+    struct Message {
+        uint8_t type;
+        uint8_t column;
+        uint16_t reserved;
+        uint32_t seq;
+        uint64_t hash;
+    };
+    static_assert(sizeof(Message) == 16, "lockstep messages must stay 16 bytes");
+
+    ~LockstepSession() {
+        if (sock >= 0) {
+            Message bye{MSG_BYE, 0, 0, sent, 0};
+            send_all(&bye);
+            close(sock);
+        }
+    }
+
+    // Waits for one guest on `addr`, then sends it the seed
+    static std::unique_ptr<LockstepSession> host(const std::string &addr, uint64_t seed) {
+        int listener = open_socket(addr, true);
+        if (listener < 0)
+            return nullptr;
+        int fd = accept(listener, nullptr, nullptr);
+        close(listener);
+        if (!is_tcp(addr))
+            unlink(addr.c_str());
+        if (fd < 0)
+            return nullptr;
+        std::unique_ptr<LockstepSession> s(new LockstepSession(fd, 0, seed));
+        Message hello{MSG_HELLO, version, 0, 0, seed};
+        Message ack;
+        if (!s->send_all(&hello) || !s->read_message(ack, true) || ack.type != MSG_HELLO || ack.column != version)
+            return nullptr;
+        return s;
+    }
+
+    static std::unique_ptr<LockstepSession> join(const std::string &addr) {
+        int fd = open_socket(addr, false);
+        if (fd < 0)
+            return nullptr;
+        std::unique_ptr<LockstepSession> s(new LockstepSession(fd, 1, 0));
+        Message hello;
+        if (!s->read_message(hello, true) || hello.type != MSG_HELLO || hello.column != version)
+            return nullptr;
+        s->rng = hello.hash | 1;
+        Message ack{MSG_HELLO, version, 0, 0, 0};
+        if (!s->send_all(&ack))
+            return nullptr;
+        return s;
+    }
+
+    int seat() const { return my_seat; }
+    int fd() const { return sock; }
+
+    // Both sides must pass the same `sides`, the game's die, or their dice part ways
+    int next_roll(int sides) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        return static_cast<int>(rng % static_cast<uint64_t>(sides)) + 1;
+    }
+
+    bool send_move(int column, uint64_t state_hash) {
+        Message m{MSG_MOVE, static_cast<uint8_t>(column), 0, sent++, state_hash};
+        return send_all(&m);
+    }
+
+    bool receive_move(int &column, uint64_t &state_hash) {
+        Message m;
+        if (!read_message(m, true) || !accept_move(m))
+            return false;
+        column     = m.column;
+        state_hash = m.hash;
+        return true;
+    }
+
+    int poll_move(int &column, uint64_t &state_hash) {
+        Message m;
+        if (!read_message(m, false))
+            return closed ? -1 : 0;
+        if (!accept_move(m))
+            return -1;
+        column     = m.column;
+        state_hash = m.hash;
+        return 1;
+    }
+
+   private:
+    int sock;
+    int my_seat;
+    uint64_t rng;
+    uint32_t sent     = 0;  // moves sent so far
+    uint32_t received = 0;  // moves received so far
+    bool closed       = false;
+    char partial[sizeof(Message)];
+    size_t have = 0;  // bytes of a message already read
+
+    LockstepSession(int fd, int seat, uint64_t seed) : sock(fd), my_seat(seat), rng(seed | 1) {}
+
+    static bool is_tcp(const std::string &addr) { return addr.find(':') != std::string::npos; }
+
+    static int open_socket(const std::string &addr, bool listening) {
+        int fd = -1;
+        if (is_tcp(addr)) {
+            size_t colon = addr.rfind(':');
+            sockaddr_in in;
+            std::memset(&in, 0, sizeof(in));
+            in.sin_family = AF_INET;
+            in.sin_port   = htons(static_cast<uint16_t>(std::atoi(addr.c_str() + colon + 1)));
+            std::string host = addr.substr(0, colon);
+            if (inet_pton(AF_INET, host.empty() ? "127.0.0.1" : host.c_str(), &in.sin_addr) != 1)
+                return -1;
+            fd = socket(AF_INET, SOCK_STREAM, 0);
+            if (fd < 0)
+                return -1;
+            int one = 1;
+            setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+            setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+            int rc = listening ? bind(fd, reinterpret_cast<sockaddr *>(&in), sizeof(in))
+                               : connect(fd, reinterpret_cast<sockaddr *>(&in), sizeof(in));
+            if (rc < 0 || (listening && listen(fd, 1) < 0)) {
+                close(fd);
+                return -1;
+            }
+        } else {
+            sockaddr_un un;
+            std::memset(&un, 0, sizeof(un));
+            un.sun_family = AF_UNIX;
+            std::strncpy(un.sun_path, addr.c_str(), sizeof(un.sun_path) - 1);
+            fd = socket(AF_UNIX, SOCK_STREAM, 0);
+            if (fd < 0)
+                return -1;
+            if (listening)
+                unlink(addr.c_str());
+            int rc = listening ? bind(fd, reinterpret_cast<sockaddr *>(&un), sizeof(un))
+                               : connect(fd, reinterpret_cast<sockaddr *>(&un), sizeof(un));
+            if (rc < 0 || (listening && listen(fd, 1) < 0)) {
+                close(fd);
+                return -1;
+            }
+        }
+        return fd;
+    }
+
+    bool send_all(const Message *m) {
+        const char *p = reinterpret_cast<const char *>(m);
+        size_t left   = sizeof(Message);
+        while (left) {
+            ssize_t n = send(sock, p, left, MSG_NOSIGNAL);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return false;
+            p += n;
+            left -= static_cast<size_t>(n);
+        }
+        return true;
+    }
+
+    // Reads one whole message; without `block` it returns false if none is complete yet
+    bool read_message(Message &m, bool block) {
+        while (have < sizeof(Message)) {
+            ssize_t n = recv(sock, partial + have, sizeof(Message) - have, block ? 0 : MSG_DONTWAIT);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+                return false;
+            if (n <= 0) {
+                closed = true;
+                return false;
+            }
+            have += static_cast<size_t>(n);
+        }
+        std::memcpy(&m, partial, sizeof(m));
+        have = 0;
+        return true;
+    }
+
+    // A move must be the next one in sequence; anything else ends the session
+    bool accept_move(const Message &m) {
+        if (m.type != MSG_MOVE || m.seq != received) {
+            closed = true;
+            return false;
+        }
+        ++received;
+        return true;
+    }
+};
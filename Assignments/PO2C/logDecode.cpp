@@ -0,0 +1,235 @@
+#include "logFormat.hpp"  // binary record layout
+#include <algorithm>       // all_of
+#include <cstdio>          // printf, fopen
+#include <cstring>         // memcmp, strcmp
+#include <string>          // string data structure
+#include <string_view>     // keys and text for JSON
+#include <utility>         // pair
+#include <vector>          // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Binary Log Decoder
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Turns a log written with Logger::Format::Binary back into the
+*        `key: value` text the logger writes in text mode. Site definitions
+*        are read as they come, so a file appended to by several runs decodes
+*        with each run's own keys. The zeros left at the end of a mapped
+*        segment by a crash are skipped. Stops at the first damaged record
+*        (e.g. one cut short by a crash) and says where it was. With `-t` each
+*        line starts with the time it was logged, as the logger's text mode
+*        writes it with Logger::setTimestamps(true). With `-j` it writes
+*        Chrome trace-event JSON instead, for chrome://tracing or Perfetto:
+*        Trace spans, counters and instants become complete, counter and
+*        instant events on their thread, and other records instant events
+*        with their text attached.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -o logDecode logDecode.cpp`
+*        - Run with `./logDecode [-t | -j] <binary_log> [out]` (output goes to
+*          stdout if no output file is given)
+*
+*  Files:             logDecode.cpp     : decoder
+*                     logFormat.hpp     : record layout shared with the logger
+*****************************************************************************/
+
+bool readFile(const char *path, std::vector<char> &data) {
+    FILE *file = std::fopen(path, "rb");
+    if (!file)
+        return false;
+    char chunk[1 << 16];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), file)) > 0)
+        data.insert(data.end(), chunk, chunk + n);
+    std::fclose(file);
+    return true;
+}
+
+// "[seconds.nanoseconds] ", as Logger writes it in text mode
+void timePrefix(LogFormat::Buffer &out, uint64_t ns) {
+    char prefix[40];
+    std::snprintf(prefix, sizeof(prefix), "[%llu.%09llu] ", static_cast<unsigned long long>(ns / 1000000000ull),
+                  static_cast<unsigned long long>(ns % 1000000000ull));
+    out.text(prefix);
+}
+
+// Writes `s` as a JSON string
+void jsonString(FILE *out, std::string_view s) {
+    std::fputc('"', out);
+    for (char c : s) {
+        if (c == '"' || c == '\\')
+            std::fprintf(out, "\\%c", c);
+        else if (static_cast<unsigned char>(c) < 0x20)
+            std::fprintf(out, "\\u%04x", c);
+        else
+            std::fputc(c, out);
+    }
+    std::fputc('"', out);
+}
+
+/**
+ * jsonEvent
+ *
+ * Description:
+ *      Writes one record, logged at `ns`, as a Chrome trace event. Trace
+ *      events keep their thread; a span's record is logged when it ends, so
+ *      it starts its length earlier. Any other record is an instant event
+ *      named by its key with its text as an argument. Returns false if a
+ *      value could not be read.
+ */
+bool jsonEvent(FILE *out, bool first, uint64_t ns, std::string_view key, uint8_t shape, LogFormat::Reader values) {
+    LogFormat::Value thread, v;
+    bool event = shape >= LogFormat::Span;
+    if (event && !(values.next(thread) && thread.tag == LogFormat::UInt))
+        return false;
+    bool hasValue = event && values.p < values.end;
+    if (hasValue && !values.next(v))
+        return false;
+    char text[8192];
+    LogFormat::Buffer args{text, text + sizeof(text)};
+    if (!event && !LogFormat::render(args, key, shape, values))
+        return false;
+
+    std::fputs(first ? "\n" : ",\n", out);
+    std::fputs("{\"name\":", out);
+    jsonString(out, key);
+    uint64_t start = shape == LogFormat::Span ? ns - v.u : ns;
+    std::fprintf(out, ",\"pid\":1,\"tid\":%llu,\"ts\":%llu.%03llu", static_cast<unsigned long long>(event ? thread.u : 0),
+                 static_cast<unsigned long long>(start / 1000), static_cast<unsigned long long>(start % 1000));
+    if (shape == LogFormat::Span) {
+        std::fprintf(out, ",\"ph\":\"X\",\"dur\":%llu.%03llu", static_cast<unsigned long long>(v.u / 1000),
+                     static_cast<unsigned long long>(v.u % 1000));
+    } else if (shape == LogFormat::Counter) {
+        LogFormat::Buffer value{text, text + sizeof(text)};
+        LogFormat::text(value, v);
+        std::fprintf(out, ",\"ph\":\"C\",\"args\":{\"value\":%.*s}", static_cast<int>(value.p - text), text);
+    } else if (event) {
+        std::fputs(",\"ph\":\"i\",\"s\":\"t\"", out);
+    } else {
+        std::fputs(",\"ph\":\"i\",\"s\":\"g\",\"args\":{\"text\":", out);
+        jsonString(out, std::string_view(text, static_cast<size_t>(args.p - text)));
+        std::fputc('}', out);
+    }
+    std::fputc('}', out);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    bool times = argc > 1 && std::strcmp(argv[1], "-t") == 0;
+    bool json  = argc > 1 && std::strcmp(argv[1], "-j") == 0;
+    if (times || json) {
+        ++argv;
+        --argc;
+    }
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s [-t | -j] <binary_log> [out]\n", argv[0]);
+        return 2;
+    }
+    std::vector<char> data;
+    if (!readFile(argv[1], data)) {
+        std::fprintf(stderr, "cannot read %s\n", argv[1]);
+        return 1;
+    }
+    if (data.size() < sizeof(LogFormat::magic) ||
+        std::memcmp(data.data(), LogFormat::magic, sizeof(LogFormat::magic)) != 0) {
+        std::fprintf(stderr, "%s is not a binary log\n", argv[1]);
+        return 1;
+    }
+    FILE *out = argc > 2 ? std::fopen(argv[2], "w") : stdout;
+    if (!out) {
+        std::fprintf(stderr, "cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, uint8_t> > sites;  // key and shape by site - firstSite
+    size_t pos     = sizeof(LogFormat::magic);
+    size_t records = 0;
+    uint64_t clock = 0;  // ns, from the last clockBase and the deltas since
+    bool damaged   = false;
+    char line[8192];  // a record's values can be several times longer as text
+    if (json)
+        std::fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", out);
+    while (pos < data.size() && !damaged) {
+        uint16_t site;
+        LogFormat::Reader values;
+        // a mapped segment that was not closed cleanly ends in zeros
+        if (data[pos] == 0 && std::all_of(data.begin() + pos, data.end(), [](char c) { return c == 0; }))
+            break;
+        size_t length = LogFormat::frame(data.data() + pos, data.size() - pos, site, values);
+        if (length == 0) {
+            damaged = true;
+            break;
+        }
+        uint64_t delta;
+        if (!values.varint(delta)) {
+            damaged = true;
+            break;
+        }
+        clock += static_cast<uint64_t>(static_cast<int64_t>(delta >> 1) ^ -static_cast<int64_t>(delta & 1));
+        LogFormat::Buffer text{line, line + sizeof(line)};
+        char *start = line;
+        if (times && site != LogFormat::defineSite && site != LogFormat::clockBase) {
+            timePrefix(text, clock);
+            start = text.p;
+        }
+        LogFormat::Value v;
+        if (site == LogFormat::clockBase) {
+            damaged = !(values.next(v) && v.tag == LogFormat::UInt);
+            clock   = v.u;
+        } else if (site == LogFormat::defineSite) {
+            LogFormat::Value id, shape, key;
+            damaged = !(values.next(id) && values.next(shape) && values.next(key) && key.tag == LogFormat::Str &&
+                        id.u >= LogFormat::firstSite);
+            if (!damaged) {
+                size_t index = id.u - LogFormat::firstSite;
+                if (sites.size() <= index)
+                    sites.resize(index + 1);
+                sites[index] = {std::string(key.s), static_cast<uint8_t>(shape.u)};
+            }
+        } else {
+            std::string_view key;
+            uint8_t shape;
+            if (site < LogFormat::firstSite) {
+                shape   = site == LogFormat::inlineList ? LogFormat::List : LogFormat::Single;
+                damaged = !(values.next(v) && v.tag == LogFormat::Str);
+                key     = v.s;
+            } else {
+                size_t index = site - LogFormat::firstSite;
+                damaged      = index >= sites.size();
+                if (!damaged) {
+                    key   = sites[index].first;
+                    shape = sites[index].second;
+                }
+            }
+            if (!damaged && json) {
+                damaged = !jsonEvent(out, records == 0, clock, key, shape, values);
+                records += !damaged;
+            } else if (!damaged) {
+                damaged = !LogFormat::render(text, key, shape, values);
+            }
+        }
+        if (damaged)
+            break;
+        if (text.p != start) {
+            std::fwrite(line, 1, static_cast<size_t>(text.p - line), out);
+            std::fputc('\n', out);
+            ++records;
+        }
+        pos += length;
+    }
+    if (json)
+        std::fputs("\n]}\n", out);
+    if (out != stdout)
+        std::fclose(out);
+
+    if (damaged) {
+        std::fprintf(stderr, "damaged record at byte %zu of %zu; %zu records decoded\n", pos, data.size(), records);
+        return 1;
+    }
+    return 0;
+}
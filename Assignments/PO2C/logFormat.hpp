@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <charconv>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * LogFormat
+ *
+ * Description:
+ *      The two ways a Logger record can be written, shared by the logger and
+ *      the offline decoder so both render a value the same way.
+ *
+ *      Text: `key: value` or `key: [a, b, c]` and a newline, as log.txt has
+ *      always looked.
+ *
+ *      Binary: the file starts with `magic`; each record is
+ *
+ *          u8 length | u16 site (little endian) | time | values | u8 length
+ *
+ *      where `length` counts the whole record, so the file can be walked
+ *      both ways, and `time` is a zigzag varint of nanoseconds since the
+ *      record before it; a `clockBase` record holds the absolute time
+ *      (CLOCK_MONOTONIC_RAW) the deltas start from. A site names a call
+ *      site; its key and shape are written once as a `defineSite` record and
+ *      the records that use it carry only their values. Each value is a tag
+ *      byte and then: a zigzag varint (Int), a varint (UInt), 8 bytes
+ *      (Double), a varint length and the bytes (Str), or nothing
+ *      (False/True). `inlineValue` and `inlineList` records have no site and
+ *      carry their key as the first value.
+ *
+ *      Sites shaped `Span`, `Counter` or `Instant` are trace events (see
+ *      Trace): the first value is the logging thread's number, then a span's
+ *      length in nanoseconds (the record's time is when it ended) or a
+ *      counter's value. As text they read "span 2 drawGrid: 1530 ns".
+ *
+ *      In memory, before the logger has put records in time order, a record
+ *      has no `time`; `stamp` adds it on the way to the file.
+ *
+ * Public Methods:
+ *      - struct Buffer          : Bounded output cursor with text and binary writers.
+ *      - struct Value / Reader  : One decoded value, and a cursor that reads them.
+ *      - static void put(Buffer&, const T&) / static void text(Buffer&, const T&)
+ *      - static void text(Buffer&, const Value&)
+ *      - static char* begin(Buffer&, uint16_t site) / static void finish(Buffer&, char* start)
+ *      - static size_t frame(const char* p, size_t size, uint16_t& site, Reader& values)
+ *      - static void stamp(Buffer& out, const char* record, size_t length, int64_t delta)
+ *      - static void event(Buffer&, std::string_view key, uint8_t shape, uint64_t thread, const V&... value)
+ *      - static bool render(Buffer&, std::string_view key, uint8_t shape, Reader values)
+ *
+ * Usage:
+ *      char line[64];
+ *      LogFormat::Buffer out{line, line + sizeof(line)};
+ *      LogFormat::text(out, 42);
+ */
+class LogFormat {
+   public:
+    enum Tag : uint8_t { Int = 1, UInt, Double, Str, False, True };
+    enum Shape : uint8_t { Single = 0, List = 1, Span = 2, Counter = 3, Instant = 4 };
+    enum : uint16_t { defineSite = 0, inlineValue = 1, inlineList = 2, clockBase = 3, firstSite = 4 };
+
+    static constexpr char magic[8]     = {'K', 'B', 'L', 'O', 'G', '0', '2', '\n'};
+    static constexpr size_t maxRecord  = 255;  // the length has to fit a byte
+    static constexpr size_t frameBytes = 4;    // both lengths and the site
+    static constexpr size_t stampBytes = 10;   // longest time delta
+
+    // Output cursor over [p, end); a value that does not fit is left out whole
+    struct Buffer {
+        char* p;
+        char* end;
+
+        size_t room() const { return static_cast<size_t>(end - p); }
+
+        void raw(const void* data, size_t n) {
+            std::memcpy(p, data, n);
+            p += n;
+        }
+
+        void varint(uint64_t v) {
+            while (v >= 0x80) {
+                *p++ = static_cast<char>(v | 0x80);
+                v >>= 7;
+            }
+            *p++ = static_cast<char>(v);
+        }
+
+        // binary values
+        void putInt(int64_t v) {
+            if (room() >= 11) {
+                *p++ = Int;
+                varint((static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63));
+            }
+        }
+        void putUInt(uint64_t v) {
+            if (room() >= 11) {
+                *p++ = UInt;
+                varint(v);
+            }
+        }
+        void putDouble(double v) {
+            if (room() >= 9) {
+                *p++ = Double;
+                raw(&v, sizeof(v));
+            }
+        }
+        void putBool(bool v) {
+            if (room() >= 1)
+                *p++ = v ? True : False;
+        }
+        void putStr(std::string_view s) {
+            if (room() < 3)
+                return;
+            size_t n = std::min(s.size(), room() - 3);
+            *p++     = Str;
+            varint(n);
+            raw(s.data(), n);
+        }
+
+        // text values, cut short at the end of the buffer
+        void text(std::string_view s) { raw(s.data(), std::min(s.size(), room())); }
+        template <typename N>
+        void number(N v) {
+            auto result = std::to_chars(p, end, v);
+            if (result.ec == std::errc())
+                p = result.ptr;
+        }
+        void textBool(bool v) { text(v ? "true" : "false"); }
+    };
+
+    // Starts a binary record for `site` at out.p; keeps back a byte for the closing length
+    static char* begin(Buffer& out, uint16_t site) {
+        char* start = out.p;
+        out.end     = std::min(out.end, start + maxRecord) - 1;
+        out.p[1]    = static_cast<char>(site & 0xff);
+        out.p[2]    = static_cast<char>(site >> 8);
+        out.p += 3;
+        return start;
+    }
+
+    // Closes the record started at `start` by writing its length at both ends
+    static void finish(Buffer& out, char* start) {
+        auto length = static_cast<char>(out.p - start + 1);
+        *out.p++    = length;
+        *start      = length;
+        out.end += 1;
+    }
+
+    // One value read back from a binary record
+    struct Value {
+        uint8_t tag = 0;
+        int64_t i   = 0;
+        uint64_t u  = 0;
+        double d    = 0;
+        std::string_view s;
+    };
+
+    // Reads the values of one record
+    struct Reader {
+        const char* p;
+        const char* end;
+
+        bool varint(uint64_t& v) {
+            v = 0;
+            for (int shift = 0; p < end && shift < 64; shift += 7) {
+                uint8_t byte = static_cast<uint8_t>(*p++);
+                v |= static_cast<uint64_t>(byte & 0x7f) << shift;
+                if (!(byte & 0x80))
+                    return true;
+            }
+            return false;
+        }
+
+        // False at the end of the record or on a malformed value
+        bool next(Value& v) {
+            if (p >= end)
+                return false;
+            v.tag = static_cast<uint8_t>(*p++);
+            switch (v.tag) {
+                case Int:
+                    if (!varint(v.u))
+                        return false;
+                    v.i = static_cast<int64_t>(v.u >> 1) ^ -static_cast<int64_t>(v.u & 1);
+                    return true;
+                case UInt:
+                    return varint(v.u);
+                case Double:
+                    if (end - p < 8)
+                        return false;
+                    std::memcpy(&v.d, p, 8);
+                    p += 8;
+                    return true;
+                case Str: {
+                    uint64_t n;
+                    if (!varint(n) || n > static_cast<uint64_t>(end - p))
+                        return false;
+                    v.s = std::string_view(p, n);
+                    p += n;
+                    return true;
+                }
+                case False:
+                case True:
+                    return true;
+            }
+            return false;
+        }
+    };
+
+    /**
+     * Reads the framing of the record at `p`, with `size` bytes available.
+     * Returns the record's length, or 0 if it is cut short or its two
+     * lengths disagree.
+     */
+    static size_t frame(const char* p, size_t size, uint16_t& site, Reader& values) {
+        if (size < frameBytes)
+            return 0;
+        size_t length = static_cast<uint8_t>(p[0]);
+        if (length < frameBytes || length > size || static_cast<uint8_t>(p[length - 1]) != length)
+            return 0;
+        site   = static_cast<uint16_t>(static_cast<uint8_t>(p[1]) | static_cast<uint8_t>(p[2]) << 8);
+        values = Reader{p + 3, p + length - 1};
+        return length;
+    }
+
+    // Copies an in-memory record to `out` with its time added, as it is stored in a file
+    static void stamp(Buffer& out, const char* record, size_t length, int64_t delta) {
+        char* start = out.p;
+        out.raw(record, 3);
+        out.varint((static_cast<uint64_t>(delta) << 1) ^ static_cast<uint64_t>(delta >> 63));
+        out.raw(record + 3, length - 4);
+        auto total = static_cast<char>(out.p - start + 1);
+        *out.p++   = total;
+        *start     = total;
+    }
+
+    // Writes one argument of a log call as a binary value
+    template <typename T>
+    static void put(Buffer& out, const T& v) {
+        if constexpr (std::is_same_v<T, bool>)
+            out.putBool(v);
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            out.putInt(v);
+        else if constexpr (std::is_integral_v<T>)
+            out.putUInt(v);
+        else if constexpr (std::is_floating_point_v<T>)
+            out.putDouble(v);
+        else
+            out.putStr(std::string_view(v));
+    }
+
+    // Writes one argument of a log call as text
+    template <typename T>
+    static void text(Buffer& out, const T& v) {
+        if constexpr (std::is_same_v<T, bool>)
+            out.textBool(v);
+        else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+            out.number(static_cast<int64_t>(v));
+        else if constexpr (std::is_integral_v<T>)
+            out.number(static_cast<uint64_t>(v));
+        else if constexpr (std::is_floating_point_v<T>)
+            out.number(static_cast<double>(v));
+        else
+            out.text(std::string_view(v));
+    }
+
+    static void text(Buffer& out, const Value& v) {
+        switch (v.tag) {
+            case Int: out.number(v.i); break;
+            case UInt: out.number(v.u); break;
+            case Double: out.number(v.d); break;
+            case Str: out.text(v.s); break;
+            case False: out.textBool(false); break;
+            case True: out.textBool(true); break;
+        }
+    }
+
+    // Text of a trace event, its value optional: "span 2 drawGrid: 1530 ns", "instant 1 turn"
+    template <typename... V>
+    static void event(Buffer& out, std::string_view key, uint8_t shape, uint64_t thread, const V&... value) {
+        out.text(shape == Span ? "span " : shape == Counter ? "counter " : "instant ");
+        out.number(thread);
+        out.text(" ");
+        out.text(key);
+        ((out.text(": "), text(out, value)), ...);
+        if (shape == Span)
+            out.text(" ns");
+    }
+
+    /**
+     * Renders the values left in `in` as the text form of a record with the
+     * given key and shape, without the newline. Returns false if a value
+     * could not be read.
+     */
+    static bool render(Buffer& out, std::string_view key, uint8_t shape, Reader in) {
+        Value v;
+        if (shape >= Span) {
+            Value thread;
+            if (!in.next(thread) || thread.tag != UInt)
+                return false;
+            if (in.p == in.end) {
+                event(out, key, shape, thread.u);
+                return true;
+            }
+            if (!in.next(v))
+                return false;
+            event(out, key, shape, thread.u, v);
+            return in.p == in.end;
+        }
+        out.text(key);
+        out.text(shape == List ? ": [" : ": ");
+        bool first = true;
+        while (in.p < in.end) {
+            if (!in.next(v))
+                return false;
+            if (!first)
+                out.text(", ");
+            text(out, v);
+            first = false;
+        }
+        if (shape == List)
+            out.text("]");
+        return true;
+    }
+};
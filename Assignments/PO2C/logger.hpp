@@ -1,114 +1,1136 @@
 #pragma once
+#include <fcntl.h>
 #include <ncurses.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
-#include <fstream>
-#include <iostream>
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <cstring>
 #include <map>
 #include <mutex>
 #include <string>
+#include <string_view>
+#include <thread>
+#include <utility>
 #include <vector>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
 
+#include "logFormat.hpp"
+
+// Lowest Logger::Level compiled in (0 Trace ... 4 Error, 5 none); e.g. -DLOGGER_MIN_LEVEL=2
+#ifndef LOGGER_MIN_LEVEL
+#define LOGGER_MIN_LEVEL 0
+#endif
+
+class Trace;  // trace.hpp: spans and counters logged through Logger
+
+/**
+ * Logger
+ *
+ * Description:
+ *      Static `key: value` logger. Each thread that logs gets its own ring of
+ *      record slots, which only it writes and only the background writer
+ *      reads, so threads never wait on each other or share a cache line.
+ *      A caller stamps its record with the time (the TSC on x86, otherwise
+ *      CLOCK_MONOTONIC_RAW), formats it straight into the slot and returns.
+ *      The writer merges the rings by time stamp and writes the records in
+ *      time order to one file descriptor that stays open. It wakes every
+ *      `flushInterval` or as soon as a ring is half full. A thread marks the
+ *      record it is filling in, and the writer writes nothing later than a
+ *      marked record, so a thread descheduled mid-record cannot end up behind
+ *      records made after it; records younger than `mergeDelay` also wait
+ *      unless their ring is filling up. Only `flush()` and shutdown write
+ *      past a marked record.
+ *      `setTimestamps(true)` prefixes text lines with the time in seconds;
+ *      binary records always carry it.
+ *
+ *      When a thread's ring is full `Overflow::Block` makes the caller wait for room
+ *      and `Overflow::Drop` throws the record away and counts it; the writer
+ *      notes dropped records in the file. A record longer than a slot is cut
+ *      short. `flush()` returns once everything logged before it is written.
+ *
+ *      A `Site` is a call site declared once, as a static, with its key and
+ *      shape. Logging through it takes the values themselves (numbers, bools,
+ *      strings) rather than text built by the caller. With `Format::Binary`
+ *      such a record is only the site number and the raw values (see
+ *      LogFormat) and nothing is formatted until logDecode turns the file
+ *      back into the usual text; with `Format::Text` the values are formatted
+ *      into the slot as before. Pick the format before the first log call.
+ *
+ *      Every log call has a Level, Info unless given as a template argument.
+ *      Calls below `compiledLevel` (set with -DLOGGER_MIN_LEVEL) are discarded
+ *      by `if constexpr`, so they compile to nothing and their site is never
+ *      registered; calls at or above it are checked against a runtime level,
+ *      one relaxed load, that `setLevel` can raise or lower. It starts at
+ *      Debug, so Trace records are only written once asked for.
+ *
+ *      By default the log is one file that grows. `setSegments` caps it:
+ *      when the next record would pass the size, the file is renamed to
+ *      `<path>.1` (older ones to .2, .3, ... up to `keep`) and a new one is
+ *      started. A mapped segment is allocated at full size up front and
+ *      mmap'd, and records are copied into it with memcpy, so once it is
+ *      open the writer makes no system calls at all. A crash can then only
+ *      cut the record being copied; the unused end of the segment is zeros,
+ *      which are skipped when the file is reopened and cut off when it is
+ *      closed.
+ *
+ *      Each thread also keeps its last `tailCount` records, as logged, so the
+ *      status line can show the latest one without reading the file. Only
+ *      that thread writes them; lastLines merges the threads by time stamp,
+ *      and a binary record is only formatted when displayed.
+ *
+ * Public Methods:
+ *      - static void setFilePath(const std::string& filename)
+ *      - static void setFormat(Format format)
+ *      - static void setSegments(size_t bytes, int keep = 4, bool mapped = true)
+ *      - static void setTimestamps(bool on)
+ *      - static void clearLogFile()
+ *      - static void log<Level>(std::string_view key, std::string_view value)
+ *      - static void log<Level>(std::string_view key, const std::vector<std::string>& values)
+ *      - static void log<Level>(std::string_view key, const std::vector<int>& values)
+ *      - static void log<Level>(const std::map<std::string, std::string>& keyValuePairs)
+ *      - static void log<Level>(const Site& site, const Args&... values)
+ *      - static void setLevel(Level level) / static bool enabled(Level level)
+ *      - static void flush()
+ *      - static void setOverflowPolicy(Overflow policy) / static uint64_t droppedCount()
+ *      - static std::string lastLine() / static std::vector<std::string> lastLines(size_t n)
+ *      - static void printLastLine(WINDOW* win)
+ *
+ * Usage:
+ *      Logger::setFilePath("game.bin");
+ *      Logger::setFormat(Logger::Format::Binary);
+ *      static const Logger::Site size("height", LogFormat::List);
+ *      Logger::log(size, height, width);   // decodes to "height: [13, 17]"
+ *      Logger::log<Logger::Level::Debug>(size, height, width);  // gone if built with -DLOGGER_MIN_LEVEL=2
+ *      Logger::flush();
+ */
 class Logger {
+    friend class Trace;
+
    public:
+    enum class Overflow { Block, Drop };
+    enum class Format { Text, Binary };
+    enum class Level : uint8_t { Trace, Debug, Info, Warn, Error, Off };
+
+    static constexpr Level compiledLevel = static_cast<Level>(LOGGER_MIN_LEVEL);
+
+    static constexpr size_t slotCount   = 1024;  // per thread; power of two
+    static constexpr size_t slotBytes   = 256;   // one record, time stamp included
+    static constexpr size_t maxSites    = 1024;
+    static constexpr size_t tailCount   = 64;  // lines each thread keeps for lastLines()
+    static constexpr size_t minSegment  = maxSites * slotBytes;  // room for a binary log's header
+    static constexpr auto flushInterval = std::chrono::milliseconds(2);
+    static constexpr auto mergeDelay    = std::chrono::milliseconds(1);
+
+    /**
+     * Site
+     *
+     * Description:
+     *      A log call site: its key, whether its values print as one value or
+     *      as a list, and the number that stands for both in a binary log.
+     *      Declare it static; the constructor is constexpr, so the site costs
+     *      nothing until its first record registers it.
+     */
+    class Site {
+       public:
+        constexpr explicit Site(const char* key, LogFormat::Shape shape = LogFormat::Single)
+            : key(key), shape(shape) {}
+
+        const char* key;
+        LogFormat::Shape shape;
+        mutable std::atomic<uint16_t> id{0};  // 0 until registered; inlineValue if the table was full
+    };
+
     // Set the log file path
-    static void setFilePath(const std::string& filename) { filePath = filename; }
+    static void setFilePath(const std::string& filename) {
+        flush();
+        std::lock_guard<std::mutex> lock(fileMutex);
+        closeFile();
+        filePath = filename;
+    }
+
+    static void setFormat(Format f) {
+        flush();
+        std::lock_guard<std::mutex> lock(fileMutex);
+        closeFile();
+        format.store(f, std::memory_order_relaxed);
+    }
+
+    // Rotate the log every `bytes` (0 for one growing file), keeping `keep` old segments
+    static void setSegments(size_t bytes, int keep = 4, bool mapped = true) {
+        flush();
+        std::lock_guard<std::mutex> lock(fileMutex);
+        closeFile();
+        segment.limit  = bytes ? std::max(bytes, minSegment) : 0;
+        segment.keep   = std::max(keep, 0);
+        segment.mapped = mapped && bytes > 0;
+    }
+
+    // Prefix each text line with its time, "[seconds.nanoseconds] "
+    static void setTimestamps(bool on) {
+        flush();
+        timestamps.store(on, std::memory_order_relaxed);
+    }
 
     static void clearLogFile() {
+        flush();
         std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::trunc);
-        if (file.is_open()) {
-            file << "Log file cleared." << std::endl;
+        closeFile();
+        if (::truncate(filePath.c_str(), 0) != 0 && errno != ENOENT)
+            std::perror("Logger: cannot clear log");
+        if (openFile()) {
+            // a binary log gets its header from openFile
+            if (!binary()) {
+                append("Log file cleared.\n", 18);
+                keepTail(local(), Clock::now(), "Log file cleared.\n", 18, false);
+            }
+            flushPending();
         }
     }
 
     // Log a single key-value pair (string, string)
-    static void log(const std::string& key, const std::string& value) {
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": " << value << std::endl;
+    template <Level L = Level::Info>
+    static void log(std::string_view key, std::string_view value) {
+        if constexpr (L >= compiledLevel) {
+            if (enabled(L))
+                logValue(key, value);
         }
     }
 
     // Log multiple values under a single key (string, vector<string>)
-    static void log(const std::string& key, const std::vector<std::string>& values) {
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": [";
-            for (size_t i = 0; i < values.size(); ++i) {
-                file << values[i];
-                if (i != values.size() - 1)
-                    file << ", ";
-            }
-            file << "]" << std::endl;
+    template <Level L = Level::Info>
+    static void log(std::string_view key, const std::vector<std::string>& values) {
+        if constexpr (L >= compiledLevel) {
+            if (enabled(L))
+                logList(key, values);
         }
     }
 
-    static void log(const std::string& key, const std::vector<int>& values) {
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            file << key << ": [";
-            for (size_t i = 0; i < values.size(); ++i) {
-                file << values[i];
-                if (i != values.size() - 1)
-                    file << ", ";
-            }
-            file << "]" << std::endl;
+    template <Level L = Level::Info>
+    static void log(std::string_view key, const std::vector<int>& values) {
+        if constexpr (L >= compiledLevel) {
+            if (enabled(L))
+                logList(key, values);
         }
     }
 
     // Log all key-value pairs in a map (map<string, string>)
+    template <Level L = Level::Info>
     static void log(const std::map<std::string, std::string>& keyValuePairs) {
-        std::lock_guard<std::mutex> lock(fileMutex);  // Thread-safe access
-        std::ofstream file(filePath, std::ios::app);
-        if (file.is_open()) {
-            for (const auto& pair : keyValuePairs) {
-                file << pair.first << ": " << pair.second << std::endl;
+        if constexpr (L >= compiledLevel) {
+            if (enabled(L)) {
+                for (const auto& pair : keyValuePairs) {
+                    logValue(pair.first, pair.second);
+                }
+            }
+        }
+    }
+
+    // Log values under a declared site; nothing is formatted in binary mode
+    template <Level L = Level::Info, typename... Args>
+    static void log(const Site& site, const Args&... values) {
+        if constexpr (L >= compiledLevel) {
+            if (enabled(L))
+                logSite(site, values...);
+        }
+    }
+
+    // Records below `level` are skipped at run time; levels not compiled in stay off
+    static void setLevel(Level level) { runtimeLevel.store(level, std::memory_order_relaxed); }
+
+    static bool enabled(Level level) {
+        return level >= compiledLevel && level >= runtimeLevel.load(std::memory_order_relaxed);
+    }
+
+    // Waits until every record logged before the call is in the file
+    static void flush() { hub().flush(); }
+
+    static void setOverflowPolicy(Overflow policy) { overflow.store(policy, std::memory_order_relaxed); }
+
+    static uint64_t droppedCount() {
+        uint64_t total = 0;
+        for (ThreadRing* ring = hub().rings.load(std::memory_order_acquire); ring; ring = ring->next)
+            total += ring->dropped.load(std::memory_order_relaxed);
+        return total;
+    }
+
+    // The most recent line logged, or "" if there is none
+    static std::string lastLine() {
+        // the newest line of whichever thread logged last
+        const ThreadRing* newest = nullptr;
+        uint64_t index = 0, newestStamp = 0;
+        for (ThreadRing* ring = hub().rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+            uint64_t next = ring->lineNext.load(std::memory_order_acquire);
+            if (next > 0 && (!newest || ring->lines[(next - 1) % tailCount].stamp > newestStamp)) {
+                newest      = ring;
+                index       = next - 1;
+                newestStamp = ring->lines[index % tailCount].stamp;
             }
         }
+        std::string line;
+        if (newest && !readTail(*newest, index, newestStamp, line)) {
+            // overwritten while we looked; take the slow path
+            std::vector<std::string> lines = lastLines(1);
+            return lines.empty() ? std::string() : lines[0];
+        }
+        return line;
+    }
+
+    // Up to `n` of the most recent lines from all threads, oldest first, without touching the file
+    static std::vector<std::string> lastLines(size_t n) {
+        struct Candidate {
+            uint64_t stamp;
+            const ThreadRing* ring;
+            uint64_t index;
+        };
+        // find the newest lines by time first, so only those are formatted
+        std::vector<Candidate> candidates;
+        for (ThreadRing* ring = hub().rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+            uint64_t next = ring->lineNext.load(std::memory_order_acquire);
+            for (uint64_t i = next; i > 0 && next - i < std::min(n, tailCount); --i)
+                candidates.push_back({ring->lines[(i - 1) % tailCount].stamp, ring, i - 1});
+        }
+        auto newer = [](const Candidate& a, const Candidate& b) { return a.stamp > b.stamp; };
+        size_t keep = std::min(n, candidates.size());
+        std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), newer);
+        std::vector<std::string> lines;
+        // a line overwritten since is skipped
+        for (size_t i = keep; i > 0; --i) {
+            uint64_t stamp;
+            std::string line;
+            if (readTail(*candidates[i - 1].ring, candidates[i - 1].index, stamp, line))
+                lines.push_back(std::move(line));
+        }
+        return lines;
     }
 
     static void printLastLine(WINDOW* win) {
-        std::ifstream file(filePath, std::ios::in | std::ios::ate);  // Open at end of file
-        std::string lastLine;
-
-        if (file.is_open()) {
-            // Start reading from the end of the file
-            file.seekg(-1, std::ios::end);
-
-            // Check for a newline character or end of file
-            bool isLastLineEmpty = (file.peek() == '\n');
-            while (file.tellg() > 0) {
-                char ch;
-                file.seekg(-1, std::ios::cur);  // Move one character back
-                ch = file.get();
-
-                if (ch == '\n' && !isLastLineEmpty) {
-                    break;
+        std::string line = lastLine();
+        mvwprintw(win, 0, 0, "                                                         ");
+        mvwprintw(win, 0, 0, "%s", line.c_str());
+        return;
+    }
+
+   private:
+    // One slot of a thread's ring: when the record was made, then its bytes
+    struct Slot {
+        uint64_t stamp;
+        uint16_t length;
+        char text[slotBytes - sizeof(uint64_t) - sizeof(uint16_t)];
+    };
+
+    // One remembered record; `seq` is odd while its thread is copying into it
+    struct TailLine {
+        std::atomic<uint64_t> seq{0};
+        uint64_t stamp  = 0;
+        uint16_t length = 0;
+        bool binary     = false;
+        char bytes[sizeof(Slot::text)];
+    };
+
+    /**
+     * ThreadRing
+     *
+     * Description:
+     *      One thread's records: a single-producer ring the writer drains,
+     *      and the thread's last few lines. Rings are kept in a list that only
+     *      grows; when a thread exits its ring is marked idle and the next new
+     *      thread takes it over once it is drained.
+     */
+    struct ThreadRing {
+        Slot slots[slotCount];
+        alignas(64) std::atomic<uint64_t> head{0};  // next position to fill; owner only
+        std::atomic<uint64_t> writing{0};           // stamp of the record being filled, 0 between records
+        uint64_t lastStamp = 1;                     // owner only
+        alignas(64) std::atomic<uint64_t> tail{0};  // next position to write out; writer only
+        std::atomic<uint64_t> dropped{0};           // owner only
+        std::atomic<bool> active{true};
+        uint32_t id      = 1;  // the thread's number in trace events, counting from 1
+        ThreadRing* next = nullptr;
+        TailLine lines[tailCount];
+        std::atomic<uint64_t> lineNext{0};  // owner only
+    };
+
+    // A claimed slot being filled in by the caller
+    struct Record : LogFormat::Buffer {
+        ThreadRing* ring = nullptr;
+        Slot* slot       = nullptr;
+        uint16_t site    = 0;
+        bool binary      = false;
+        bool keep        = true;  // copied to the tail for lastLines()
+
+        Record() : LogFormat::Buffer{nullptr, nullptr} {}
+    };
+
+    struct SiteInfo {
+        const char* key;
+        LogFormat::Shape shape;
+    };
+
+    /**
+     * Clock
+     *
+     * Description:
+     *      Time stamps for records. On x86 a stamp is the TSC, one instruction
+     *      and steady across cores on any recent CPU; elsewhere it is
+     *      CLOCK_MONOTONIC_RAW in nanoseconds. `ns` turns a stamp into
+     *      CLOCK_MONOTONIC_RAW nanoseconds, with the TSC rate measured from
+     *      start up and refined by `calibrate` as time goes on.
+     */
+    struct Clock {
+        uint64_t ticks0 = 0, ns0 = 0;
+        std::atomic<double> nsPerTick{1.0};  // read by tracing threads too
+
+        static uint64_t monotonicNs() {
+            timespec ts;
+            ::clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+            return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+        }
+
+        static uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+            return __rdtsc();
+#else
+            return monotonicNs();
+#endif
+        }
+
+        Clock() {
+            ticks0 = now();
+            ns0    = monotonicNs();
+            // a first rate from a millisecond; calibrate() improves it later
+            while (monotonicNs() - ns0 < 1000000) {
+            }
+            calibrate();
+        }
+
+        void calibrate() {
+            uint64_t ticks = now(), ns = monotonicNs();
+            if (ticks > ticks0)
+                nsPerTick.store(static_cast<double>(ns - ns0) / static_cast<double>(ticks - ticks0),
+                                std::memory_order_relaxed);
+        }
+
+        uint64_t ns(uint64_t stamp) const { return ns0 + elapsed(ticks0, stamp); }
+
+        // Nanoseconds between two stamps
+        uint64_t elapsed(uint64_t from, uint64_t to) const {
+            double rate = nsPerTick.load(std::memory_order_relaxed);
+            return static_cast<uint64_t>(static_cast<double>(static_cast<int64_t>(to - from)) * rate);
+        }
+
+        uint64_t ticks(std::chrono::nanoseconds span) const {
+            return static_cast<uint64_t>(static_cast<double>(span.count()) / nsPerTick.load(std::memory_order_relaxed));
+        }
+    };
+
+    /**
+     * Hub
+     *
+     * Description:
+     *      The list of thread rings, the clock and the writer thread. Built on
+     *      the first log call; at exit the writer drains what is left, closes
+     *      the file and stops.
+     */
+    struct Hub {
+        std::atomic<ThreadRing*> rings{nullptr};
+        Clock clock;
+        std::atomic<bool> stopping{false};
+        std::mutex wakeMutex;
+        std::condition_variable wake;  // writer waits here
+        std::condition_variable done;  // flush() waits here
+        uint64_t flushAsked = 0;       // both under wakeMutex
+        uint64_t flushDone  = 0;
+        std::thread writer;
+
+        Hub() { writer = std::thread([this]() { run(); }); }
+
+        ~Hub() {
+            stopping.store(true);
+            nudge();
+            writer.join();
+            for (ThreadRing* ring = rings.load(); ring;) {
+                ThreadRing* next = ring->next;
+                delete ring;
+                ring = next;
+            }
+        }
+
+        // A ring for a new thread: an idle, drained one if there is one
+        ThreadRing* attach() {
+            for (ThreadRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+                bool idle = false;
+                if (!ring->active.load(std::memory_order_relaxed) &&
+                    ring->tail.load(std::memory_order_acquire) == ring->head.load(std::memory_order_relaxed) &&
+                    ring->active.compare_exchange_strong(idle, true, std::memory_order_acquire))
+                    return ring;
+            }
+            ThreadRing* ring = new ThreadRing();
+            ring->next       = rings.load(std::memory_order_relaxed);
+            do {
+                ring->id = ring->next ? ring->next->id + 1 : 1;
+            } while (!rings.compare_exchange_weak(ring->next, ring, std::memory_order_release));
+            return ring;
+        }
+
+        bool claim(Record& r) {
+            ThreadRing& ring = local();
+            uint64_t pos     = ring.head.load(std::memory_order_relaxed);
+            while (pos - ring.tail.load(std::memory_order_acquire) >= slotCount) {
+                // the writer has not emptied this ring yet
+                if (overflow.load(std::memory_order_relaxed) == Overflow::Drop) {
+                    ring.dropped.store(ring.dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                    return false;
+                }
+                nudge();
+                std::this_thread::yield();
+            }
+            // Say a record is coming before reading the clock, with a time it
+            // cannot be earlier than; a thread descheduled right after reading
+            // the clock still holds the merge back.
+            ring.writing.store(ring.lastStamp, std::memory_order_release);
+            r.ring         = &ring;
+            r.slot         = &ring.slots[pos & (slotCount - 1)];
+            r.slot->stamp  = Clock::now();
+            ring.lastStamp = r.slot->stamp;
+            ring.writing.store(r.slot->stamp, std::memory_order_release);
+            r.p            = r.slot->text;
+            r.end          = r.slot->text + sizeof(r.slot->text);
+            return true;
+        }
+
+        void publish(Record& r) {
+            ThreadRing& ring = *r.ring;
+            uint64_t pos     = ring.head.load(std::memory_order_relaxed);
+            r.slot->length   = static_cast<uint16_t>(r.p - r.slot->text);
+            ring.head.store(pos + 1, std::memory_order_release);
+            ring.writing.store(0, std::memory_order_release);
+            // only wake the writer early when the ring is filling up
+            if (pos - ring.tail.load(std::memory_order_relaxed) == slotCount / 2)
+                nudge();
+        }
+
+        void flush() {
+            std::unique_lock<std::mutex> lock(wakeMutex);
+            uint64_t ticket = ++flushAsked;
+            wake.notify_one();
+            done.wait(lock, [&]() { return flushDone >= ticket; });
+        }
+
+        void nudge() {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            wake.notify_one();
+        }
+
+        // Where the writer is in one ring, and the time of the record there
+        struct Cursor {
+            ThreadRing* ring;
+            uint64_t pos, end, stamp;
+
+            const Slot& slot() const { return ring->slots[pos & (slotCount - 1)]; }
+        };
+
+        /**
+         * Writes out, in time order, the records published when the pass
+         * started that are no later than `cutoff`. Returns how many it wrote.
+         * Caller holds fileMutex.
+         */
+        size_t pass(uint64_t cutoff, bool open) {
+            std::vector<Cursor> heap;
+            auto later = [](const Cursor& a, const Cursor& b) { return a.stamp > b.stamp; };
+            for (ThreadRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+                Cursor c{ring, ring->tail.load(std::memory_order_relaxed), ring->head.load(std::memory_order_acquire), 0};
+                if (c.pos != c.end) {
+                    c.stamp = c.slot().stamp;
+                    heap.push_back(c);
+                }
+            }
+            std::make_heap(heap.begin(), heap.end(), later);
+            size_t count = 0;
+            while (!heap.empty() && heap.front().stamp <= cutoff) {
+                std::pop_heap(heap.begin(), heap.end(), later);
+                Cursor& c = heap.back();
+                // take this ring's run of records up to the next ring's first
+                uint64_t until = heap.size() > 1 ? std::min(heap.front().stamp, cutoff) : cutoff;
+                uint64_t first = c.pos;
+                do {
+                    if (open)
+                        emit(c.slot(), clock);
+                    c.ring->tail.store(++c.pos, std::memory_order_release);
+                } while (c.pos != c.end && (c.stamp = c.slot().stamp) <= until);
+                count += c.pos - first;
+                if (c.pos == c.end)
+                    heap.pop_back();
+                else
+                    std::push_heap(heap.begin(), heap.end(), later);
+            }
+            return count;
+        }
+
+        void run() {
+            uint64_t reported   = 0;
+            auto lastCalibrated = std::chrono::steady_clock::now();
+            for (;;) {
+                uint64_t asked;
+                bool stop;
+                {
+                    std::lock_guard<std::mutex> lock(wakeMutex);
+                    asked = flushAsked;
+                    stop  = stopping.load();
+                }
+                if (std::chrono::steady_clock::now() - lastCalibrated > std::chrono::milliseconds(100)) {
+                    clock.calibrate();
+                    lastCalibrated = std::chrono::steady_clock::now();
+                }
+                bool all       = stop || asked != flushDone;
+                bool waiting   = false;
+                bool filling   = false;
+                uint64_t lost  = droppedCount();
+                size_t written = 0;
+                uint64_t now   = Clock::now();
+                uint64_t first = UINT64_MAX;  // earliest record still being filled in
+                for (ThreadRing* ring = rings.load(std::memory_order_acquire); ring; ring = ring->next) {
+                    uint64_t stamp  = ring->writing.load(std::memory_order_acquire);
+                    uint64_t queued = ring->head.load(std::memory_order_acquire) - ring->tail.load(std::memory_order_relaxed);
+                    waiting |= queued > 0;
+                    filling |= queued >= slotCount / 2;
+                    if (stamp)
+                        first = std::min(first, stamp - 1);
+                }
+                // A flush or the last pass takes everything. Otherwise nothing
+                // goes ahead of a record still being filled in, and young
+                // records wait out the delay unless their ring is filling up.
+                uint64_t cutoff = all ? UINT64_MAX : std::min(first, now - (filling ? 0 : clock.ticks(mergeDelay)));
+                // the file is only opened once there is something to put in it
+                if (waiting || lost != reported) {
+                    std::lock_guard<std::mutex> lock(fileMutex);
+                    bool open = openFile();
+                    written   = pass(cutoff, open);
+                    if (lost != reported && open) {
+                        Slot note;
+                        note.stamp = Clock::now();
+                        LogFormat::Buffer text{note.text, note.text + sizeof(note.text) - LogFormat::stampBytes};
+                        noteDropped(text, lost - reported);
+                        note.length = static_cast<uint16_t>(text.p - note.text);
+                        emit(note, clock);
+                        reported = lost;
+                    }
+                    if (open)
+                        flushPending();
                 }
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                if (all) {
+                    flushDone = asked;
+                    done.notify_all();
+                    if (stop)
+                        break;
+                }
+                if (written == 0 && flushAsked == flushDone)
+                    wake.wait_for(lock, flushInterval);
+            }
+            std::lock_guard<std::mutex> lock(fileMutex);
+            closeFile();
+        }
+    };
+
+    static Hub& hub() {
+        static Hub instance;
+        return instance;
+    }
+
+    // The calling thread's ring, taken on its first record and given back when it exits
+    static ThreadRing& local() {
+        struct Owner {
+            ThreadRing* ring = nullptr;
+            ~Owner() {
+                if (ring)
+                    ring->active.store(false, std::memory_order_release);
+            }
+        };
+        thread_local Owner owner;
+        if (!owner.ring)
+            owner.ring = hub().attach();
+        return *owner.ring;
+    }
+
+    static bool binary() { return format.load(std::memory_order_relaxed) == Format::Binary; }
 
-                if (ch != '\n') {
-                    lastLine.insert(lastLine.begin(), ch);  // Insert character at the beginning
-                    file.seekg(-1, std::ios::cur);
+    // Claims a slot and opens a record for `site` in the current format
+    static bool begin(Record& r, uint16_t site) {
+        if (!hub().claim(r))
+            return false;
+        r.site   = site;
+        r.binary = binary();
+        if (r.binary) {
+            LogFormat::begin(r, site);
+            r.end -= LogFormat::stampBytes;  // room for the time the writer adds
+        } else {
+            r.end -= 1;  // kept back for the newline
+        }
+        return true;
+    }
+
+    static void finish(Record& r) {
+        if (r.binary) {
+            r.end += LogFormat::stampBytes;
+            LogFormat::finish(r, r.slot->text);
+        } else {
+            *r.p++ = '\n';
+        }
+        if (r.keep && r.site != LogFormat::defineSite)
+            keepTail(*r.ring, r.slot->stamp, r.slot->text, static_cast<size_t>(r.p - r.slot->text), r.binary);
+        hub().publish(r);
+    }
+
+    /**
+     * Writes one record to the file in time order: a binary record gets its
+     * time as a delta from the record before, a text line its time prefix
+     * if timestamps are on. An empty slot, a claim given up, is skipped.
+     * Caller holds fileMutex.
+     */
+    static void emit(const Slot& slot, const Clock& clock) {
+        if (slot.length == 0)
+            return;
+        uint64_t ns = clock.ns(slot.stamp);
+        char out[LogFormat::maxRecord + 32];
+        LogFormat::Buffer b{out, out + sizeof(out)};
+        if (binary()) {
+            LogFormat::stamp(b, slot.text, slot.length, static_cast<int64_t>(ns - fileClock));
+            fileClock = ns;
+        } else {
+            if (timestamps.load(std::memory_order_relaxed)) {
+                b.text("[");
+                b.number(ns / 1000000000ull);
+                char fraction[10] = {'.'};
+                uint64_t digits   = ns % 1000000000ull;
+                for (int i = 9; i > 0; --i, digits /= 10)
+                    fraction[i] = static_cast<char>('0' + digits % 10);
+                b.raw(fraction, sizeof(fraction));
+                b.text("] ");
+            }
+            b.raw(slot.text, slot.length);
+        }
+        append(out, static_cast<size_t>(b.p - out));
+    }
+
+    static void logValue(std::string_view key, std::string_view value) {
+        Record r;
+        if (!begin(r, LogFormat::inlineValue))
+            return;
+        if (r.binary) {
+            r.putStr(key);
+            r.putStr(value);
+        } else {
+            r.text(key);
+            r.text(": ");
+            r.text(value);
+        }
+        finish(r);
+    }
+
+    template <typename T>
+    static void logList(std::string_view key, const std::vector<T>& values) {
+        Record r;
+        if (!begin(r, LogFormat::inlineList))
+            return;
+        if (r.binary) {
+            r.putStr(key);
+            for (const T& value : values)
+                LogFormat::put(r, value);
+        } else {
+            r.text(key);
+            r.text(": [");
+            for (size_t i = 0; i < values.size(); ++i) {
+                LogFormat::text(r, values[i]);
+                if (i != values.size() - 1)
+                    r.text(", ");
+            }
+            r.text("]");
+        }
+        finish(r);
+    }
+
+    template <typename... Args>
+    static void logSite(const Site& site, const Args&... values) {
+        uint16_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0)
+            id = defineSite(site);
+        if (id == LogFormat::inlineValue && site.shape == LogFormat::List)
+            id = LogFormat::inlineList;
+        Record r;
+        if (!begin(r, id))
+            return;
+        if (r.binary) {
+            if (id < LogFormat::firstSite)
+                r.putStr(site.key);
+            (LogFormat::put(r, values), ...);
+        } else {
+            bool first = true;
+            r.text(site.key);
+            r.text(site.shape == LogFormat::List ? ": [" : ": ");
+            ((first ? void(first = false) : r.text(", "), LogFormat::text(r, values)), ...);
+            if (site.shape == LogFormat::List)
+                r.text("]");
+        }
+        finish(r);
+    }
+
+    // A span's length: the time from `start` to the stamp of the record that logs it
+    struct Since {
+        uint64_t start;
+    };
+
+    template <typename V>
+    static const V& resolve(const Record&, const V& value) {
+        return value;
+    }
+
+    static uint64_t resolve(const Record& r, const Since& since) {
+        return hub().clock.elapsed(since.start, r.slot->stamp);
+    }
+
+    /**
+     * Logs a trace event for Trace: the thread's number, then the value if
+     * there is one. Events stay out of the tail so the status line keeps
+     * showing the game's own records.
+     */
+    template <typename... V>
+    static void logEvent(const Site& site, const V&... value) {
+        uint16_t id = site.id.load(std::memory_order_acquire);
+        if (id == 0)
+            id = defineSite(site);
+        Record r;
+        if (id < LogFormat::firstSite || !begin(r, id))
+            return;  // a full site table has no room for events
+        r.keep = false;
+        if (r.binary) {
+            r.putUInt(r.ring->id);
+            (LogFormat::put(r, resolve(r, value)), ...);
+        } else {
+            LogFormat::event(r, site.key, site.shape, r.ring->id, resolve(r, value)...);
+        }
+        finish(r);
+    }
+
+    // Registers a site on its first record and, in binary mode, writes its definition to the log
+    static uint16_t defineSite(const Site& site) {
+        // the definition is stamped before any thread can log with the id,
+        // so the merge puts it ahead of them
+        Record r;
+        bool define = binary() && begin(r, LogFormat::defineSite);
+        uint16_t id;
+        {
+            std::lock_guard<std::mutex> lock(siteMutex);
+            id           = site.id.load(std::memory_order_relaxed);
+            size_t count = siteCount.load(std::memory_order_relaxed);
+            if (id == 0 && count == maxSites) {
+                id = LogFormat::inlineValue;
+                site.id.store(id, std::memory_order_release);
+            }
+            if (id != 0) {
+                // another thread got here first; the claimed slot goes out empty
+                if (define) {
+                    r.p = r.slot->text;
+                    hub().publish(r);
                 }
-                isLastLineEmpty = false;
+                return id;
+            }
+            sites[count] = SiteInfo{site.key, site.shape};
+            siteCount.store(count + 1, std::memory_order_release);
+            id = static_cast<uint16_t>(LogFormat::firstSite + count);
+            if (define) {
+                // a file opened in between also gets it from writeHeader; a repeat is harmless
+                siteValues(r, id, sites[count]);
+                finish(r);
             }
-            file.close();
+            site.id.store(id, std::memory_order_release);
+        }
+        return id;
+    }
+
+    static void siteValues(LogFormat::Buffer& out, uint16_t id, const SiteInfo& site) {
+        out.putUInt(id);
+        out.putUInt(site.shape);
+        out.putStr(site.key);
+    }
+
+    static void noteDropped(LogFormat::Buffer& out, uint64_t count) {
+        char value[48];
+        LogFormat::Buffer text{value, value + sizeof(value)};
+        text.number(count);
+        text.text(" records dropped");
+        std::string_view message(value, static_cast<size_t>(text.p - value));
+        if (binary()) {
+            char* start = LogFormat::begin(out, LogFormat::inlineValue);
+            out.putStr("Logger");
+            out.putStr(message);
+            LogFormat::finish(out, start);
         } else {
-            std::cerr << "Unable to open file: " << filePath << std::endl;
+            out.text("Logger: ");
+            out.text(message);
+            out.text("\n");
+        }
+    }
+
+    /**
+     * Copies a finished record into its thread's tail. Line i holds sequence
+     * 2i + 2 when complete and an odd number while it is being copied, so a
+     * reader that finds anything else, or sees the number change under it,
+     * skips the line.
+     */
+    static void keepTail(ThreadRing& ring, uint64_t stamp, const char* bytes, size_t length, bool isBinary) {
+        uint64_t index = ring.lineNext.load(std::memory_order_relaxed);
+        TailLine& line = ring.lines[index % tailCount];
+        line.seq.store(index * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        std::memcpy(line.bytes, bytes, length);
+        line.stamp  = stamp;
+        line.length = static_cast<uint16_t>(length);
+        line.binary = isBinary;
+        line.seq.store(index * 2 + 2, std::memory_order_release);
+        ring.lineNext.store(index + 1, std::memory_order_release);
+    }
+
+    // Reads line `index` of a thread's tail as text; false if it is being written or was overwritten
+    static bool readTail(const ThreadRing& ring, uint64_t index, uint64_t& stamp, std::string& text) {
+        const TailLine& line = ring.lines[index % tailCount];
+        uint64_t before      = line.seq.load(std::memory_order_acquire);
+        if (before != index * 2 + 2)
+            return false;
+        char bytes[sizeof(Slot::text)];
+        size_t length = line.length;
+        bool isBinary = line.binary;
+        stamp         = line.stamp;
+        std::memcpy(bytes, line.bytes, sizeof(bytes));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (line.seq.load(std::memory_order_relaxed) != before || length > sizeof(bytes))
+            return false;
+        if (!isBinary) {
+            text.assign(bytes, length && bytes[length - 1] == '\n' ? length - 1 : length);
+            return true;
+        }
+        uint16_t site = 0;
+        LogFormat::Reader values;
+        if (LogFormat::frame(bytes, length, site, values) != length)
+            return false;
+        char rendered[slotBytes * 4];
+        LogFormat::Buffer out{rendered, rendered + sizeof(rendered)};
+        bool ok;
+        if (site < LogFormat::firstSite) {
+            LogFormat::Value key;
+            ok = values.next(key) && key.tag == LogFormat::Str &&
+                 LogFormat::render(out, key.s, site == LogFormat::inlineList ? LogFormat::List : LogFormat::Single,
+                                   values);
+        } else {
+            size_t i = site - LogFormat::firstSite;
+            ok       = i < siteCount.load(std::memory_order_acquire) &&
+                 LogFormat::render(out, sites[i].key, sites[i].shape, values);
+        }
+        if (ok)
+            text.assign(rendered, out.p);
+        return ok;
+    }
+
+    // The open file: how much of it holds records, and its mapping if it is mapped
+    struct Segment {
+        size_t limit = 0;  // rotate before passing this size; 0 never
+        int keep     = 4;
+        bool mapped  = false;
+        char* base   = nullptr;
+        size_t used  = 0;
+    };
+
+    /**
+     * Opens the log file for appending if it is not open, mapping it when
+     * segments are mapped, and starts a binary log with its header. An
+     * existing file in the other format is shifted aside first, so a binary
+     * log never has text in it and the other way round. Caller holds
+     * fileMutex.
+     */
+    static bool openFile() {
+        if (fd >= 0)
+            return true;
+        fd = ::open(filePath.c_str(), O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+        if (fd < 0)
+            return false;
+        off_t size   = ::lseek(fd, 0, SEEK_END);
+        segment.used = size > 0 ? static_cast<size_t>(size) : 0;
+        if (segment.used > 0 && startsWithMagic() != binary()) {
+            // a log in the other format (or from an older version) is moved aside, not appended to
+            ::close(fd);
+            fd = -1;
+            shiftSegments();
+            return openFile();
+        }
+        if (segment.mapped) {
+            if (segment.used > segment.limit) {
+                // an older, bigger log is moved aside whole
+                ::close(fd);
+                fd = -1;
+                shiftSegments();
+                return openFile();
+            }
+            if (segment.used == segment.limit || ::posix_fallocate(fd, 0, static_cast<off_t>(segment.limit)) == 0) {
+                void* base = ::mmap(nullptr, segment.limit, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+                if (base != MAP_FAILED) {
+                    segment.base = static_cast<char*>(base);
+                    // after a crash the records end where the zeros start
+                    while (segment.used > 0 && segment.base[segment.used - 1] == 0)
+                        --segment.used;
+                } else if (::ftruncate(fd, static_cast<off_t>(segment.used)) != 0) {
+                    closeFile();
+                    return false;
+                }
+            }
+        }
+        if (binary())
+            writeHeader();
+        return true;
+    }
+
+    // Whether the open file begins with the binary log's magic. Caller holds fileMutex.
+    static bool startsWithMagic() {
+        char head[sizeof(LogFormat::magic)];
+        return ::pread(fd, head, sizeof(head), 0) == static_cast<ssize_t>(sizeof(head)) &&
+               std::memcmp(head, LogFormat::magic, sizeof(head)) == 0;
+    }
+
+    /**
+     * Starts this process's part of a binary log: the magic if the file is
+     * empty, then every site known so far, since site numbers are only
+     * meaningful within one run. Caller holds fileMutex.
+     */
+    static void writeHeader() {
+        if (segment.used == 0)
+            append(LogFormat::magic, sizeof(LogFormat::magic));
+        char record[slotBytes], stamped[LogFormat::maxRecord];
+        auto put = [&](LogFormat::Buffer& out, char* start) {
+            LogFormat::finish(out, start);
+            LogFormat::Buffer file{stamped, stamped + sizeof(stamped)};
+            LogFormat::stamp(file, record, static_cast<size_t>(out.p - record), 0);
+            append(stamped, static_cast<size_t>(file.p - stamped));
+        };
+        // the times that follow count from here
+        if (fileClock == 0)
+            fileClock = Clock::monotonicNs();
+        LogFormat::Buffer out{record, record + sizeof(record)};
+        char* start = LogFormat::begin(out, LogFormat::clockBase);
+        out.putUInt(fileClock);
+        put(out, start);
+        std::lock_guard<std::mutex> lock(siteMutex);
+        size_t count = siteCount.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            out   = LogFormat::Buffer{record, record + sizeof(record) - LogFormat::stampBytes};
+            start = LogFormat::begin(out, LogFormat::defineSite);
+            siteValues(out, static_cast<uint16_t>(LogFormat::firstSite + i), sites[i]);
+            put(out, start);
+        }
+    }
+
+    // Adds one record (or header piece) to the file, starting a new segment first if it would not fit
+    static void append(const char* data, size_t size) {
+        if (segment.limit && segment.used > 0 && segment.used + size > segment.limit) {
+            closeFile();
+            shiftSegments();
+            if (!openFile())
+                return;
+        }
+        if (segment.base) {
+            std::memcpy(segment.base + segment.used, data, size);
+        } else {
+            if (pendingBytes + size > sizeof(pending))
+                flushPending();
+            std::memcpy(pending + pendingBytes, data, size);
+            pendingBytes += size;
+        }
+        segment.used += size;
+    }
+
+    // Writes what unmapped appends have gathered
+    static void flushPending() {
+        if (pendingBytes > 0 && fd >= 0)
+            writeAll(pending, pendingBytes);
+        pendingBytes = 0;
+    }
+
+    // Moves the current file to <path>.1, .1 to .2 and so on, dropping the oldest
+    static void shiftSegments() {
+        if (segment.keep == 0) {
+            std::remove(filePath.c_str());
+            return;
+        }
+        for (int i = segment.keep - 1; i >= 1; --i) {
+            std::string from = filePath + "." + std::to_string(i);
+            std::rename(from.c_str(), (filePath + "." + std::to_string(i + 1)).c_str());
+        }
+        std::rename(filePath.c_str(), (filePath + ".1").c_str());
+    }
+
+    // Closes the file; a mapped segment is cut back to the records in it
+    static void closeFile() {
+        if (fd < 0)
+            return;
+        flushPending();
+        if (segment.base) {
+            ::munmap(segment.base, segment.limit);
+            segment.base = nullptr;
+            if (::ftruncate(fd, static_cast<off_t>(segment.used)) != 0)
+                std::perror("Logger: cannot trim log segment");
+        }
+        ::close(fd);
+        fd = -1;
+    }
+
+    static void writeAll(const char* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::write(fd, data, size);
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                return;
+            data += n;
+            size -= static_cast<size_t>(n);
         }
-        mvwprintw(win, 0, 0, "                                                         ");
-        mvwprintw(win, 0, 0, lastLine.c_str());
-        return;
     }
 
-   private:
     static std::string filePath;
     static std::mutex fileMutex;  // Mutex to ensure thread-safe file writing
+    static int fd;                // the open log file, or -1
+    static Segment segment;
+    static char pending[64 * 1024];  // unmapped appends waiting for one write
+    static size_t pendingBytes;
+    static std::atomic<Overflow> overflow;
+    static std::atomic<Format> format;
+    static std::atomic<Level> runtimeLevel;
+    static SiteInfo sites[maxSites];
+    static std::atomic<size_t> siteCount;
+    static std::mutex siteMutex;
+    static std::atomic<bool> timestamps;
+    static uint64_t fileClock;  // time of the last binary record written, in ns
 };
 
-// Define the static member variables
-std::string Logger::filePath = "log.txt";
-std::mutex Logger::fileMutex;
\ No newline at end of file
+// Define the static member variables; inline, so every file that includes this shares one copy
+inline std::string Logger::filePath = "log.txt";
+inline std::mutex Logger::fileMutex;
+inline int Logger::fd = -1;
+inline Logger::Segment Logger::segment;
+inline char Logger::pending[64 * 1024];
+inline size_t Logger::pendingBytes = 0;
+inline std::atomic<Logger::Overflow> Logger::overflow{Logger::Overflow::Block};
+inline std::atomic<Logger::Format> Logger::format{Logger::Format::Text};
+inline std::atomic<Logger::Level> Logger::runtimeLevel{Logger::Level::Debug};
+inline Logger::SiteInfo Logger::sites[Logger::maxSites];
+inline std::atomic<size_t> Logger::siteCount{0};
+inline std::mutex Logger::siteMutex;
+inline std::atomic<bool> Logger::timestamps{false};
+inline uint64_t Logger::fileClock = 0;
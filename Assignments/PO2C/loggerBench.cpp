@@ -0,0 +1,214 @@
+#include "logFormat.hpp"   // list shape for the site
+#include "logger.hpp"      // ring-buffer logger
+#include "statsClass.hpp"  // per-call latency histogram
+#include "trace.hpp"       // spans
+#include <chrono>          // timing
+#include <cstdio>          // printf
+#include <cstdlib>         // strtoul, strtod
+#include <fstream>         // the old open-per-call logger
+#include <mutex>           // the old logger's lock
+#include <string>          // string data structure
+#include <thread>          // logging threads
+#include <vector>          // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Logger Benchmark
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Times the caller's side of Logger::log from several threads: values
+*        turned into strings at the call site, values logged through a Site as
+*        text and as binary, binary with the ring set to drop when full, binary
+*        into rotating 16 MB mapped segments, text with time stamps, Trace
+*        spans (logged in binary, and with tracing turned off), and the old
+*        logger that locked a mutex and opened the file on every call.
+*        Prints ns per call (mean, p50, p99), how long the final flush took,
+*        how many records were dropped and the bytes written per record, and
+*        the cost of reading the latest line back for the status line. The
+*        time-stamped run also checks that the threads' records were merged
+*        into time order.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o loggerBench loggerBench.cpp -lncurses`
+*        - Run with `./loggerBench [records_per_thread] [threads] [log_path]`
+*        - The binary runs write `log_path`.bin; check it with logDecode
+*
+*  Files:             loggerBench.cpp   : benchmark driver
+*                     logger.hpp        : the logger being timed
+*****************************************************************************/
+
+std::mutex oldMutex;
+
+// What every Logger::log call used to do
+void oldLog(const std::string &path, const std::string &key, const std::string &value) {
+    std::lock_guard<std::mutex> lock(oldMutex);
+    std::ofstream file(path, std::ios::app);
+    if (file.is_open()) {
+        file << key << ": " << value << std::endl;
+    }
+}
+
+size_t countLines(const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    size_t lines = 0;
+    while (std::getline(file, line))
+        ++lines;
+    return lines;
+}
+
+// Lines of a time-stamped text log whose time is earlier than the line before
+size_t countOutOfOrder(const std::string &path) {
+    std::ifstream file(path);
+    std::string line;
+    double last   = 0;
+    size_t behind = 0;
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] != '[')
+            continue;
+        // seconds.nanoseconds fits a double to well under a microsecond
+        double seconds = std::strtod(line.c_str() + 1, nullptr);
+        if (seconds < last)
+            ++behind;
+        last = std::max(last, seconds);
+    }
+    return behind;
+}
+
+/**
+ * timeThreads
+ *
+ * Description:
+ *      Runs `body(thread, i)` `records` times on each of `threads` threads and
+ *      returns the merged per-call times. Every 16th call is timed on its own
+ *      so the clock reads do not dominate the numbers.
+ */
+template <typename Body>
+Histogram timeThreads(int threads, int records, Body body, double &secs) {
+    std::vector<Histogram> perThread(threads);
+    std::vector<std::thread> pool;
+    auto start = std::chrono::steady_clock::now();
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            for (int i = 0; i < records; ++i) {
+                if (i % 16 == 0) {
+                    auto before = std::chrono::steady_clock::now();
+                    body(t, i);
+                    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - before);
+                    perThread[t].record(static_cast<uint64_t>(ns.count()));
+                } else {
+                    body(t, i);
+                }
+            }
+        });
+    }
+    for (auto &th : pool)
+        th.join();
+    secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    Histogram all;
+    for (const Histogram &h : perThread)
+        all.merge(h);
+    return all;
+}
+
+void report(const char *name, const Histogram &h, double secs, int calls) {
+    std::printf("%-14s %8.1f ns/call  p50 %6llu  p99 %7llu  (%d calls in %.3fs)\n", name, secs * 1e9 / calls,
+                static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(99)),
+                calls, secs);
+}
+
+/**
+ * runRing
+ *
+ * Description:
+ *      Logs `records` grid positions per thread through the ring, then
+ *      flushes and reports the call cost, the flush time, drops, and the
+ *      bytes written per record.
+ */
+template <typename Body>
+void runRing(const char *name, Logger::Overflow policy, Logger::Format format, const std::string &path, int threads,
+             int records, Body body) {
+    Logger::setFormat(format);
+    Logger::setFilePath(path);
+    Logger::clearLogFile();
+    Logger::setOverflowPolicy(policy);
+    uint64_t droppedBefore = Logger::droppedCount();
+    double secs;
+    Histogram h = timeThreads(threads, records, body, secs);
+    auto before = std::chrono::steady_clock::now();
+    Logger::flush();
+    double flushSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - before).count();
+    report(name, h, secs, threads * records);
+    uint64_t dropped = Logger::droppedCount() - droppedBefore;
+    uint64_t kept    = static_cast<uint64_t>(threads) * records - dropped;
+    // rotated segments count too
+    double bytes = 0;
+    for (int n = 0; n < 10; ++n) {
+        std::ifstream file(n ? path + "." + std::to_string(n) : path, std::ios::binary | std::ios::ate);
+        if (file)
+            bytes += static_cast<double>(file.tellg());
+    }
+    std::printf("%-14s flush %.2fms, dropped %llu, %.1f bytes/record\n", "", flushSecs * 1e3,
+                static_cast<unsigned long long>(dropped), kept ? bytes / kept : 0.0);
+}
+
+int main(int argc, char **argv) {
+    int records      = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 200000;
+    int threads      = argc > 2 ? static_cast<int>(std::strtoul(argv[2], nullptr, 10)) : 4;
+    std::string path = argc > 3 ? argv[3] : "/tmp/knucklebones-bench.log";
+
+    // what Grid's constructor used to do: build strings for the values, then log them
+    auto strings = [](int t, int i) { Logger::log("yx", std::vector<std::string>{std::to_string(t), std::to_string(i)}); };
+    static const Logger::Site position("yx", LogFormat::List);
+    auto site = [](int t, int i) { Logger::log(position, t, i); };
+
+    runRing("strings, text", Logger::Overflow::Block, Logger::Format::Text, path, threads, records, strings);
+    runRing("site, text", Logger::Overflow::Block, Logger::Format::Text, path, threads, records, site);
+    runRing("site, binary", Logger::Overflow::Block, Logger::Format::Binary, path + ".bin", threads, records, site);
+    runRing("site, drop", Logger::Overflow::Drop, Logger::Format::Binary, path + ".bin", threads, records, site);
+    Logger::setSegments(16 << 20, 4);
+    runRing("site, mmap", Logger::Overflow::Block, Logger::Format::Binary, path + ".seg", threads, records, site);
+    Logger::setSegments(0);
+    Logger::setTimestamps(true);
+    runRing("site, stamped", Logger::Overflow::Block, Logger::Format::Text, path, threads, records, site);
+    Logger::setTimestamps(false);
+    size_t behind = countOutOfOrder(path);
+    std::printf("%-14s %zu records out of time order\n", "", behind);
+
+    // an empty scope, so all that is timed is the span itself
+    static const Logger::Site scope("bench", LogFormat::Span);
+    auto span = [](int, int) { Trace::Span timed(scope); };
+    Logger::setLevel(Logger::Level::Trace);
+    runRing("span, binary", Logger::Overflow::Block, Logger::Format::Binary, path + ".bin", threads, records, span);
+    Logger::setLevel(Logger::Level::Debug);
+    runRing("span, off", Logger::Overflow::Block, Logger::Format::Binary, path + ".bin", threads, records, span);
+
+    // the status line reads the in-memory tail, however long the file is
+    auto start       = std::chrono::steady_clock::now();
+    size_t shown     = 0;
+    const int reads  = 100000;
+    for (int i = 0; i < reads; ++i)
+        shown += Logger::lastLine().size();
+    double readSecs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::printf("%-14s %8.1f ns/call  (\"%s\", %zu chars shown)\n", "lastLine", readSecs * 1e9 / reads,
+                Logger::lastLine().c_str(), shown);
+    Logger::setFormat(Logger::Format::Text);
+
+    // the old logger is slow enough that a tenth of the records is plenty
+    int oldRecords = std::max(1, records / 10);
+    std::remove(path.c_str());
+    double secs;
+    Histogram h = timeThreads(threads, oldRecords,
+                              [&](int t, int i) {
+                                  oldLog(path, "yx", "[" + std::to_string(t) + ", " + std::to_string(i) + "]");
+                              },
+                              secs);
+    report("open per call", h, secs, threads * oldRecords);
+
+    size_t expected = static_cast<size_t>(threads) * oldRecords;
+    return countLines(path) == expected && behind == 0 ? 0 : 1;
+}
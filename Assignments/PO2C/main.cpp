@@ -1,17 +1,26 @@
+#include "agentClass.hpp"    // computer players
+#include "bookClass.hpp"     // opening book
 #include "buttonClass.hpp"   // button class
 #include "colors.hpp"        // color class
 #include "diceClass.hpp"     // calls class for the dice roll
 #include "gridClass.hpp"     // class to utilize the grid for knucklebones
+#include "lockstepClass.hpp" // networked two-player games
 #include "logger.hpp"        // logger utility
+#include "schedulerClass.hpp" // coroutine tasks and scheduler
+#include "solverClass.hpp"   // solution table for the exact bot
+#include "statsClass.hpp"    // end-of-game statistics
+#include "strategyClass.hpp" // strategy interface for bots
+#include "trace.hpp"         // spans and counters for a trace viewer
+#include <chrono>            // animation frame timing
 #include <fstream>           // file I/O
 #include <iostream>          // input/output
 #include <locale.h>          // setting locales
 #include <map>               // map data structure
+#include <memory>            // unique_ptr
 #include <ncurses.h>         // Ncurses library
 #include <string>            // string data structure
 #include <vector>            // vector data structure
 #include <ctime>             // rand and time operations
-#include <unistd.h>          // usleep for animation
 
 /*****************************************************************************
 *
@@ -28,16 +37,39 @@
 *        went unused.
 *
 *  Usage:
-*        - Compile the program with `g++ -o knucklebones main.cpp buttonClass.cpp colors.cpp diceClass.cpp gridClass.cpp logger.cpp -lncurses`
-*        - Run the game with `./knucklebones`
-*        - Players can roll a dice and it will appear on screen.
+*        - Compile the program with
+*          `g++ -std=c++20 -pthread -o knucklebones main.cpp boardVariants.cpp -lncurses`
+*          and add `-DLOGGER_MIN_LEVEL=2` to build without the debug logging
+*          (`-DLOGGER_MIN_LEVEL=1` drops only the tracing).
+*        - Put `--trace <file>` first to log where the time goes, in binary, to
+*          <file>; `./logDecode -j <file> trace.json` makes a trace to open in
+*          chrome://tracing or Perfetto.
+*        - Run the game with `./knucklebones [random|greedy|expectimax|mcts] [book_file]`;
+*          naming a bot makes it player 2, otherwise two people share the keyboard.
+*          A book made by bookGen gives the bot its opening moves.
+*        - `./knucklebones solver <table_file>` plays player 2 exactly from a table made
+*          by solver, with expectimax for any position the table does not hold.
+*        - For two players on two terminals run `./knucklebones host <addr>` in one and
+*          `./knucklebones join <addr>` in the other; <addr> is a socket path or host:port.
+*          The host is Player 1.
+*        - Players can roll a dice and it will appear on screen, then press 1-3
+*          to pick the column for it.
 *
 *  Files:             main.cpp    : driver program for the Knucklebones game
 *                     buttonClass.hpp  : class for button functionality (if used)
+*                     compositorClass.hpp : widgets drawn in one screen update per frame
 *                     colors.hpp        : class for color handling
 *                     diceClass.hpp     : dice handling class
 *                     gridClass.hpp     : class for grid management
 *                     logger.hpp        : utility for logging events
+*                     trace.hpp         : spans and counters logged through the logger
+*                     schedulerClass.hpp : coroutine tasks and the scheduler driving them
+*                     strategyClass.hpp : strategy interface and simple bots
+*                     agentClass.hpp    : MCTS bot
+*                     bookClass.hpp     : memory-mapped opening book
+*                     solverClass.hpp   : solution table behind the solver bot
+*                     statsClass.hpp    : score and game length histograms
+*                     lockstepClass.hpp : lockstep play between two processes
 *****************************************************************************/
 
 /**
@@ -63,25 +95,30 @@ void show_image(const std::string& image_path) {
  *
  * Description:
  *      Animates the dice rolling by displaying a sequence of images.
- *      This simulates a rolling effect for the player.
+ *      This simulates a rolling effect for the player. Between frames the
+ *      task is suspended on a timer, so other games keep running.
  *
  * Params:
- *      void
+ *      Scheduler& sched : scheduler that resumes the task after each frame
  *
  * Returns:
- *      void
+ *      GameTask : finishes after the last frame
  */
-void animate_dice() {
+GameTask animate_dice(Scheduler &sched) {
+    static const Logger::Site drawFrame("animate_dice frame", LogFormat::Span);
     for (int i = 1; i <= 24; i++) {
-        // Construct the filename for the animation frame
-        std::string frame = (i < 10) ? "00" + std::to_string(i) + ".png" : "0" + std::to_string(i) + ".png";
-        
-        // Clear the screen and display the current frame
-        clear();
-        show_image(frame);
+        {
+            Trace::Span span(drawFrame);  // the drawing only, not the wait
+            // Construct the filename for the animation frame
+            std::string frame = (i < 10) ? "00" + std::to_string(i) + ".png" : "0" + std::to_string(i) + ".png";
+
+            // Clear the screen and display the current frame
+            clear();
+            show_image(frame);
+        }
         
         // Wait for a brief moment to simulate animation (e.g., 50ms per frame)
-        usleep(50000);  // 50 milliseconds
+        co_await sched.sleep_for(std::chrono::milliseconds(50));
     }
 }
 
@@ -91,10 +128,11 @@ void animate_dice() {
  * Description:
  *      This class represents a dice that can be rolled with a configurable number
  *      of sides. The dice is used by players in the Knucklebones game to generate
- *      random values during their turn.
+ *      random values during their turn. The number of sides is a template
+ *      parameter so variants (e.g. d8) cost nothing at run time.
  *
  * Public Methods:
- *      - Dice(int sides = 6) : Constructor that initializes the dice with a given number of sides.
+ *      - Dice()              : Constructor that initializes the dice.
  *      - int roll()          : Rolls the dice and returns the result.
  *      - int get_value()     : Returns the last rolled value.
  *
@@ -102,23 +140,23 @@ void animate_dice() {
  *      - None
  *
  * Usage:
- *      Dice dice;              // Create a dice with 6 sides
+ *      Dice<> dice;            // Create a dice with 6 sides (Dice<8> for a d8)
  *      int roll_value = dice.roll();  // Roll the dice and store the value
  *      int value = dice.get_value();  // Get the value of the last roll
  */
+template <int Sides = 6>
 class Dice {
 public:
-  Dice(int sides = 6) : sides(sides), current_value(1) {}
+  Dice() : current_value(1) {}
 
   int roll() {
-    current_value = rand() % sides + 1;
+    current_value = rand() % Sides + 1;
     return current_value;
   }
 
   int get_value() const { return current_value; }
 
 private:
-  int sides;         // Number of sides on the die
   int current_value; // Last rolled value
 };
 
@@ -127,39 +165,45 @@ private:
  *
  * Description:
  *      This class represents a player in the Knucklebones game. Each player
- *      has a name, a score, and a 3x3 grid where dice values can be placed.
- *      Players take turns rolling dice, placing them on their grid, and removing
- *      opponent's dice if necessary.
+ *      has a name, a score, and a Rows x Cols grid (3x3 by default) where dice
+ *      values can be placed. Players take turns rolling dice, placing them on
+ *      their grid, and removing opponent's dice if necessary. Board size and
+ *      die sides are template parameters, so the scoring and placement loops
+ *      are unrolled for each variant.
  *
  * Public Methods:
  *      - Player(const std::string &name)   : Constructor to initialize the player with a name.
- *      - int roll_dice()                   : Rolls the dice and returns the result.
+ *      - int roll_dice()                   : Rolls the dice and returns the result (the game plays the animation).
  *      - void place_die(int column, int value) : Places the rolled die value in the specified column.
  *      - int get_score()                   : Returns the player's score.
  *      - void remove_opponent_die(int column, int value) : Removes an opponent's die from the grid.
+ *      - bool column_full(int column)      : Checks if one column of the grid is full.
  *      - bool check_full_grid()            : Checks if the player's grid is full.
+ *      - const GridType &get_grid()        : The grid, grid[column][row], for building game states.
  *
  * Private Methods:
  *      - void update_score()               : Updates the player's score based on their grid.
  *
  * Usage:
- *      Player p1("Player1");            // Create player 1
+ *      Player<> p1("Player1");          // Create player 1 (Player<4, 4, 8> for a 4x4 d8 game)
  *      int roll = p1.roll_dice();        // Roll the dice
  *      p1.place_die(0, roll);            // Place the rolled value in column 0
  *      int score = p1.get_score();       // Get player's score
  */
+template <int Rows = 3, int Cols = 3, int Sides = 6>
 class Player {
 public:
+  using GridType = int[Cols][Rows];
+
   Player(const std::string &name)
-      : name(name), score(0), grid(3, std::vector<int>(3, 0)) {}
+      : name(name), score(0), grid{} {}
 
   int roll_dice() {
-    animate_dice();  // Show dice animation before rolling
     return dice.roll();
   }
 
   void place_die(int column, int value) {
-    for (int row = 0; row < 3; ++row) {
+    for (int row = 0; row < Rows; ++row) {
       if (grid[column][row] == 0) {
         grid[column][row] = value;
         break;
@@ -171,14 +215,23 @@ public:
   int get_score() const { return score; }
 
   void remove_opponent_die(int column, int value) {
-    for (int row = 0; row < 3; ++row) {
+    for (int row = 0; row < Rows; ++row) {
       if (grid[column][row] == value) {
         grid[column][row] = 0;
+        update_score();
         break;
       }
     }
   }
 
+  bool column_full(int column) const {
+    for (int cell : grid[column]) {
+      if (cell == 0)
+        return false;
+    }
+    return true;
+  }
+
   bool check_full_grid() const {
     for (const auto &column : grid) {
       for (int cell : column) {
@@ -189,25 +242,29 @@ public:
     return true;
   }
 
+  const GridType &get_grid() const { return grid; }
+
 private:
   std::string name;                   // Player's name
   int score;                          // Player's score
-  Dice dice;                          // Player's dice
-  std::vector<std::vector<int>> grid; // Player's 3x3 grid
+  Dice<Sides> dice;                   // Player's dice
+  int grid[Cols][Rows];               // Player's grid, grid[column][row]
 
   void update_score() {
+    static const Logger::Site scoring("Player::update_score", LogFormat::Span);
+    Trace::Span span(scoring);
     score = 0;
-    for (int col = 0; col < 3; ++col) {
+    for (int col = 0; col < Cols; ++col) {
       int col_score = 0;
-      std::vector<int> counts(7, 0); // counts for dice values 1-6
-      for (int row = 0; row < 3; ++row) {
+      int counts[Sides + 1] = {}; // counts for dice values 1-Sides
+      for (int row = 0; row < Rows; ++row) {
         int value = grid[col][row];
         if (value > 0) {
           counts[value]++;
           col_score += value;
         }
       }
-      for (int value = 1; value <= 6; ++value) {
+      for (int value = 1; value <= Sides; ++value) {
         if (counts[value] > 1) {
           col_score += (counts[value] - 1) * value * counts[value];
         }
@@ -224,40 +281,153 @@ private:
  *      This class manages the entire Knucklebones game. It initializes the players,
  *      starts the game loop, and handles player turns, including rolling dice, 
  *      placing dice on the grid, and removing opponent's dice. It checks for the 
- *      game's end conditions and displays the final scores.
+ *      game's end conditions and displays the final scores. It takes the same
+ *      board size and die template parameters as Player.
  *
  * Public Methods:
  *      - KnucklebonesGame(const std::string &player1_name, const std::string &player2_name) : 
  *        Constructor to initialize the game with two players.
+ *      - GameTask play(Scheduler &sched, int channel = 0) : Turn logic as a coroutine; waits on
+ *        the dice animation and on input delivered to `channel` without blocking the thread.
+ *      - void set_agent(int player_idx, std::unique_ptr<AgentType> agent) : Lets a bot play
+ *        for that player instead of reading keys.
+ *      - void set_stats(GameStats *stats) : Records every finished game into `stats`; one
+ *        GameStats can be shared by games on any number of threads.
+ *      - void set_lockstep(LockstepSession *net) : Plays against another process. Dice come
+ *        from the session's shared stream, the other seat's columns arrive on `channel + 1`,
+ *        and after every move both sides compare state hashes.
  *      - void start_game() : Starts the game and runs the game loop.
  *      - void end_game() : Ends the game and displays the final scores.
  *
  * Private Methods:
- *      - bool check_full_game() : Checks if the game is over (e.g., when both players' grids are full).
+ *      - bool check_full_game() : Checks if the game is over (when either player's grid is full).
  *      - void handle_die_removal(int player_idx, int column, int value) : Handles the logic for removing opponent's die.
  *
  * Usage:
- *      KnucklebonesGame game("Player1", "Player2");  // Create a game with two players
+ *      KnucklebonesGame<> game("Player1", "Player2");  // Create a game with two players
+ *      game.set_agent(1, std::unique_ptr<Agent>(new GreedyAgent()));  // optional bot
  *      game.start_game();                            // Start the game
+ *
+ *      Scheduler sched;                              // or run many games on one thread
+ *      sched.spawn(game.play(sched, 0));
+ *      sched.run();
  */
+template <int Rows = 3, int Cols = 3, int Sides = 6>
 class KnucklebonesGame {
 public:
+  using PlayerType = Player<Rows, Cols, Sides>;
+  using StateType  = BasicGameState<Rows, Cols, Sides>;
+  using AgentType  = BasicAgent<StateType>;
+
   KnucklebonesGame(const std::string &player1_name, const std::string &player2_name)
       : player1(player1_name), player2(player2_name), current_player_idx(0) {}
 
-  void start_game() {
+  GameTask play(Scheduler &sched, int channel = 0) {
     while (!check_full_game()) {
-      Player &current_player = (current_player_idx == 0) ? player1 : player2;
+      PlayerType &current_player = (current_player_idx == 0) ? player1 : player2;
+      static const Logger::Site turn("turn", LogFormat::Instant);
+      Trace::instant(turn);
       // Roll dice and take player actions
-      int roll = current_player.roll_dice();
-      int column = 0;  // Get user input for column (this is simplified for now)
+      co_await animate_dice(sched);
+      int roll    = lockstep ? lockstep->next_roll(Sides) : current_player.roll_dice();
+      bool remote = lockstep && current_player_idx != lockstep->seat();
+      int column;
+      if (remote) {
+        printw("Player %d rolled a %d, waiting for their move\n", current_player_idx + 1, roll);
+        refresh();
+        column = co_await sched.input(channel + 1);
+        if (column < 0 || column >= Cols || current_player.column_full(column)) {
+          problem = "Lost the connection to the other player.";
+          break;
+        }
+      } else if (agents[current_player_idx]) {
+        static const Logger::Site choosing("Agent::choose", LogFormat::Span);
+        StateType state = StateType::from_grids(player1.get_grid(), player2.get_grid(), current_player_idx);
+        {
+          Trace::Span span(choosing);
+          column = agents[current_player_idx]->choose(state, roll);
+        }
+        printw("Player %d rolled a %d and picks column %d\n", current_player_idx + 1, roll, column + 1);
+        refresh();
+        co_await sched.sleep_for(std::chrono::milliseconds(750));
+      } else {
+        printw("Player %d rolled a %d, pick a column (1-%d)\n", current_player_idx + 1, roll, Cols);
+        refresh();
+        column = co_await sched.input(channel);
+        while (column < 0 || column >= Cols || current_player.column_full(column)) {
+          column = co_await sched.input(channel);
+        }
+      }
       current_player.place_die(column, roll);
+      handle_die_removal(current_player_idx, column, roll);
+      ++moves;
+      static const Logger::Site scores[2] = {Logger::Site("Player 1 score", LogFormat::Counter),
+                                             Logger::Site("Player 2 score", LogFormat::Counter)};
+      Trace::counter(scores[0], player1.get_score());
+      Trace::counter(scores[1], player2.get_score());
       current_player_idx = (current_player_idx == 0) ? 1 : 0;
+
+      if (lockstep) {
+        uint64_t hash = StateType::from_grids(player1.get_grid(), player2.get_grid(), current_player_idx).key();
+        if (!remote && !lockstep->send_move(column, hash)) {
+          problem = "Lost the connection to the other player.";
+          break;
+        }
+        if (remote && hash != remote_hash) {
+          problem = "The games went out of sync, stopping.";
+          break;
+        }
+      }
+    }
+    if (problem) {
+      printw("%s\n", problem);
+      refresh();
+      co_await sched.sleep_for(std::chrono::seconds(2));
+      co_return;
     }
     end_game();
   }
 
+  void set_stats(GameStats *sink) {
+    stats = sink;
+  }
+
+  void set_lockstep(LockstepSession *net) {
+    lockstep = net;
+  }
+
+  void set_agent(int player_idx, std::unique_ptr<AgentType> agent) {
+    agents[player_idx] = std::move(agent);
+  }
+
+  void start_game() {
+    Scheduler sched;
+    sched.set_idle([this, &sched]() {
+      // Keys 1-Cols pick a column for the game waiting on channel 0
+      int ch = getch();
+      if (ch >= '1' && ch < '1' + Cols) {
+        sched.provide_input(0, ch - '1');
+      }
+      // The other process's moves go to channel 1; until the game asks for
+      // one it stays buffered in the socket
+      if (lockstep && sched.waiting_for_input(1)) {
+        int column;
+        uint64_t hash = 0;
+        int got = lockstep->poll_move(column, hash);
+        if (got != 0) {
+          remote_hash = hash;
+          sched.provide_input(1, got > 0 ? column : -1);
+        }
+      }
+    });
+    sched.spawn(play(sched, 0));
+    sched.run();
+  }
+
   void end_game() {
+    if (stats) {
+      stats->record(StateType::from_grids(player1.get_grid(), player2.get_grid(), current_player_idx), moves);
+    }
     clear();
     if (player1.get_score() > player2.get_score()) {
       printw("Player 1 wins with a score of %d!\n", player1.get_score());
@@ -270,16 +440,23 @@ public:
   }
 
 private:
-  Player player1;     // First player
-  Player player2;     // Second player
+  PlayerType player1; // First player
+  PlayerType player2; // Second player
   int current_player_idx; // Index of the current player (0 for player1, 1 for player2)
+  std::unique_ptr<AgentType> agents[2]; // Bot for each player, empty for a human
+  GameStats *stats = nullptr; // Where finished games are recorded, if anywhere
+  int moves = 0; // Dice placed so far
+  LockstepSession *lockstep = nullptr; // Link to the other player's process, if networked
+  uint64_t remote_hash = 0; // State hash sent with the last remote move
+  const char *problem = nullptr; // Why the game stopped early, if it did
 
+  // Same rules as GameState, which the bots search with: the game ends once either board is full
   bool check_full_game() {
-    return player1.check_full_grid() && player2.check_full_grid();
+    return player1.check_full_grid() || player2.check_full_grid();
   }
 
   void handle_die_removal(int player_idx, int column, int value) {
-    Player &opponent = (player_idx == 0) ? player2 : player1;
+    PlayerType &opponent = (player_idx == 0) ? player2 : player1;
     opponent.remove_opponent_die(column, value);
   }
 };
@@ -299,14 +476,67 @@ private:
  *      0 if the program runs successfully.
  */
 int main(int argc, char **argv) {
+  if (argc > 2 && std::string(argv[1]) == "--trace") {
+    // Spans and counters go to the named file in binary, for logDecode -j
+    Logger::setFilePath(argv[2]);
+    Logger::setFormat(Logger::Format::Binary);
+    Logger::setLevel(Logger::Level::Trace);
+    argc -= 2;
+    argv += 2;
+  }
+
   setlocale(LC_ALL, "");  // Set locale for Ncurses
 
   initscr();  // Initialize the screen
   cbreak();   // Disable line buffering
   noecho();   // Disable automatic echoing of input
   curs_set(0);  // Hide the cursor
+  nodelay(stdscr, TRUE);  // getch() returns right away so animations keep running
 
-  KnucklebonesGame game("Player1", "Player2");
+  KnucklebonesGame<> game("Player1", "Player2");
+  std::string bot = argc > 1 ? argv[1] : "";
+  std::unique_ptr<LockstepSession> net;
+  if ((bot == "host" || bot == "join") && argc > 2) {
+    printw("%s %s ...\n", bot == "host" ? "Waiting for the other player on" : "Connecting to", argv[2]);
+    refresh();
+    net = bot == "host" ? LockstepSession::host(argv[2], static_cast<uint64_t>(time(nullptr)))
+                        : LockstepSession::join(argv[2]);
+    if (!net) {
+      endwin();
+      std::cerr << "Unable to " << bot << " a game at " << argv[2] << std::endl;
+      return 1;
+    }
+    game.set_lockstep(net.get());
+  }
+  std::unique_ptr<Agent> agent;
+  if (bot == "random") {
+    agent.reset(new RandomAgent(time(nullptr)));
+  } else if (bot == "greedy") {
+    agent.reset(new GreedyAgent());
+  } else if (bot == "expectimax") {
+    agent.reset(new ExpectimaxAgent(3));
+  } else if (bot == "mcts") {
+    agent.reset(new MctsAgent(std::chrono::milliseconds(200), 0));
+  } else if (bot == "solver" && argc > 2) {
+    // Exact moves from the table, expectimax wherever the table has no entry
+    auto table = std::make_shared<SolutionTable>();
+    if (!table->load(argv[2])) {
+      endwin();
+      std::cerr << "Unable to load solution table: " << argv[2] << std::endl;
+      return 1;
+    }
+    agent.reset(new SolverAgent(table, std::unique_ptr<Agent>(new ExpectimaxAgent(3))));
+  }
+  if (agent && argc > 2 && bot != "solver") {
+    // Opening moves come straight from the mapped book, the bot thinks after that
+    auto book = std::make_shared<OpeningBook>();
+    if (book->open(argv[2])) {
+      agent.reset(new BookAgent(book, std::move(agent)));
+    }
+  }
+  if (agent) {
+    game.set_agent(1, std::move(agent));
+  }
   game.start_game();
 
   endwin();  // End Ncurses mode
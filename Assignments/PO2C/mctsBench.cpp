@@ -0,0 +1,91 @@
+#include "boardState.hpp"  // compact game state
+#include "mctsClass.hpp"   // MCTS agent
+#include <chrono>          // budgets
+#include <cstdlib>         // strtoul
+#include <iostream>        // input/output
+#include <random>          // dice for the matches
+#include <thread>          // hardware_concurrency
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones MCTS Scaling
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Measures how the MCTS player's strength grows with threads and time.
+*        Each configuration plays a fixed reference (1 thread, 5ms per move)
+*        with seeded dice, swapping who goes first every game, and reports the
+*        score rate and the iterations it managed per move.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o mctsBench mctsBench.cpp boardVariants.cpp`
+*        - Run with `./mctsBench [games_per_config] [max_threads]`
+*
+*  Files:             mctsBench.cpp     : driver program for the measurement
+*                     mctsClass.hpp     : MCTS agent and node arena
+*                     boardState.hpp    : compact game state and rules
+*****************************************************************************/
+
+/**
+ * play_match
+ *
+ * Description:
+ *      Plays one game between the candidate and the reference with dice
+ *      drawn from `seed`, and adds up the candidate's search effort.
+ *
+ * Params:
+ *      MctsPlayer& candidate : player being measured
+ *      MctsPlayer& reference : fixed opponent
+ *      int candidate_side    : 0 if the candidate moves first, 1 otherwise
+ *      uint32_t seed         : dice sequence
+ *      uint64_t& iterations  : candidate search iterations are added here
+ *      int& moves            : candidate moves are added here
+ *
+ * Returns:
+ *      double : 1 if the candidate won, 0.5 for a tie, 0 otherwise
+ */
+double play_match(MctsPlayer &candidate, MctsPlayer &reference, int candidate_side, uint32_t seed, uint64_t &iterations, int &moves) {
+    std::mt19937 dice(seed);
+    GameState s;
+    while (!s.is_over()) {
+        int roll = static_cast<int>(dice() % 6) + 1;
+        if (s.turn == candidate_side) {
+            s.place(candidate.choose(s, roll), roll);
+            iterations += candidate.last_stats().iterations;
+            ++moves;
+        } else {
+            s.place(reference.choose(s, roll), roll);
+        }
+    }
+    int mine = s.score(candidate_side), theirs = s.score(candidate_side ^ 1);
+    return mine > theirs ? 1.0 : (mine == theirs ? 0.5 : 0.0);
+}
+
+int main(int argc, char **argv) {
+    int games            = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 20;
+    unsigned max_threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : std::thread::hardware_concurrency();
+    if (max_threads == 0)
+        max_threads = 1;
+
+    const int budgets_ms[] = {5, 20, 80};
+    std::cout << "threads budget_ms score_rate iterations/move" << std::endl;
+    for (unsigned threads = 1; threads <= max_threads; threads *= 2) {
+        for (int ms : budgets_ms) {
+            MctsPlayer candidate(threads, std::chrono::milliseconds(ms), 11);
+            MctsPlayer reference(1, std::chrono::milliseconds(5), 29);
+            double points       = 0.0;
+            uint64_t iterations = 0;
+            int moves           = 0;
+            for (int g = 0; g < games; ++g) {
+                // each dice sequence is played once from each side
+                uint32_t seed = static_cast<uint32_t>(1000 + g / 2);
+                points += play_match(candidate, reference, g % 2, seed, iterations, moves);
+            }
+            std::cout << threads << " " << ms << " " << points / games << " " << (moves ? iterations / moves : 0) << std::endl;
+        }
+    }
+    return 0;
+}
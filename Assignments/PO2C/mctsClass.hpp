@@ -0,0 +1,321 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "boardState.hpp"
+
+/**
+ * NodeArena
+ *
+ * Description:
+ *      Fixed capacity pool for MCTS nodes. Nodes are handed out in contiguous
+ *      blocks (all children of a node sit next to each other) and referred to
+ *      by 32-bit index, so a search never calls the allocator after the pool
+ *      is built and a whole tree is freed by resetting one counter.
+ */
+template <typename Node>
+class NodeArena {
+   public:
+    explicit NodeArena(uint32_t capacity) : nodes(capacity) {}
+
+    // First index of `count` fresh nodes, or UINT32_MAX if the pool is exhausted
+    uint32_t allocate(uint32_t count) {
+        if (used + count > nodes.size())
+            return UINT32_MAX;
+        uint32_t first = used;
+        used += count;
+        for (uint32_t i = first; i < used; ++i)
+            nodes[i] = Node();
+        return first;
+    }
+
+    Node &operator[](uint32_t i) { return nodes[i]; }
+    void reset() { used = 0; }
+    uint32_t size() const { return used; }
+
+   private:
+    std::vector<Node> nodes;
+    uint32_t used = 0;
+};
+
+/**
+ * MctsPlayer
+ *
+ * Description:
+ *      Anytime Monte Carlo Tree Search agent for the GameState rules. The tree
+ *      alternates decision nodes (a known die to place, one child per legal
+ *      column) and chance nodes (the next player is about to roll, one child
+ *      per die face, sampled uniformly). Decisions use UCT, new leaves are
+ *      scored with a random playout.
+ *
+ *      Search is root-parallel: every thread grows its own tree in its own
+ *      arena with its own random stream, and the visit counts and results of
+ *      the root's columns are summed when time runs out. The column with the
+ *      most visits is played. The arenas are built on the first move and
+ *      reset on every later one, so a move never allocates or clears them.
+ *
+ * Public Methods:
+ *      - MctsPlayer(unsigned threads = 0, std::chrono::microseconds budget = 100ms, uint64_t seed = 1)
+ *      - int choose(const GameState& state, int roll) : Column to play, -1 if none is legal.
+ *      - const SearchStats& last_stats() const        : Totals from the last search.
+ *
+ * Usage:
+ *      MctsPlayer ai(4, std::chrono::milliseconds(50));
+ *      int column = ai.choose(state, roll);
+ */
+class MctsPlayer {
+   public:
+    static constexpr int cols  = GameState::cols;
+    static constexpr int sides = GameState::sides;
+
+    struct SearchStats {
+        uint64_t iterations = 0;
+        uint64_t nodes      = 0;
+        uint32_t visits[cols] = {};
+        double value[cols]    = {};  // mean result of each root column for the mover
+    };
+
+    MctsPlayer(unsigned threads = 0, std::chrono::microseconds budget = std::chrono::milliseconds(100), uint64_t seed = 1,
+               uint32_t nodes_per_thread = 1 << 18)
+        : budget(budget), seed(seed), nodes_per_thread(nodes_per_thread) {
+        thread_count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    int choose(const GameState &state, int roll) {
+        stats = SearchStats();
+        int legal = -1, legal_count = 0;
+        for (int col = 0; col < cols; ++col) {
+            if (!state.column_full(state.turn, col)) {
+                legal = col;
+                ++legal_count;
+            }
+        }
+        if (legal_count <= 1)
+            return legal;
+
+        if (searches.empty()) {
+            searches.reserve(thread_count);
+            for (unsigned t = 0; t < thread_count; ++t)
+                searches.emplace_back(nodes_per_thread);
+        }
+        std::vector<SearchStats> per_thread(thread_count);
+        std::vector<std::thread> pool;
+        auto deadline = std::chrono::steady_clock::now() + budget;
+        ++seed;
+        auto work = [&](unsigned t) {
+            searches[t].run(state, roll, seed * 0x9E3779B97F4A7C15ull + t, deadline, per_thread[t]);
+        };
+        for (unsigned t = 1; t < thread_count; ++t)
+            pool.emplace_back(work, t);
+        work(0);
+        for (auto &th : pool)
+            th.join();
+
+        double wins[cols] = {};
+        for (const auto &s : per_thread) {
+            stats.iterations += s.iterations;
+            stats.nodes += s.nodes;
+            for (int col = 0; col < cols; ++col) {
+                stats.visits[col] += s.visits[col];
+                wins[col] += s.value[col] * s.visits[col];
+            }
+        }
+        int best = legal;
+        for (int col = 0; col < cols; ++col) {
+            stats.value[col] = stats.visits[col] ? wins[col] / stats.visits[col] : 0.0;
+            if (!state.column_full(state.turn, col) && stats.visits[col] > stats.visits[best])
+                best = col;
+        }
+        return best;
+    }
+
+    const SearchStats &last_stats() const { return stats; }
+
+   private:
+    std::chrono::microseconds budget;
+    uint64_t seed;
+    uint32_t nodes_per_thread;
+    unsigned thread_count;
+    SearchStats stats;
+
+    struct Node {
+        GameState state;
+        uint32_t first_child = UINT32_MAX;
+        uint32_t visits      = 0;
+        double wins0         = 0.0;  // summed results for player 0
+        uint8_t roll         = 0;    // die to place; 0 marks a chance node
+        uint8_t move         = 0;    // column that led here from a decision node
+        uint8_t child_count  = 0;
+    };
+
+    // One thread's tree; nothing in here is shared
+    class Search {
+       public:
+        explicit Search(uint32_t capacity) : arena(capacity) {}
+
+        // Grows a fresh tree in the same arena until the deadline
+        void run(const GameState &root_state, int roll, uint64_t seed, std::chrono::steady_clock::time_point deadline,
+                 SearchStats &out) {
+            arena.reset();
+            rng                 = seed | 1;
+            uint32_t root       = arena.allocate(1);
+            arena[root].state   = root_state;
+            arena[root].roll    = static_cast<uint8_t>(roll);
+            uint64_t iterations = 0;
+            do {
+                // checking the clock every iteration costs more than the iteration itself
+                for (int i = 0; i < 64; ++i)
+                    iterate(root);
+                iterations += 64;
+            } while (std::chrono::steady_clock::now() < deadline);
+
+            out.iterations = iterations;
+            out.nodes      = arena.size();
+            const Node &r  = arena[root];
+            for (uint32_t i = 0; i < r.child_count; ++i) {
+                const Node &c      = arena[r.first_child + i];
+                out.visits[c.move] = c.visits;
+                double mean0       = c.visits ? c.wins0 / c.visits : 0.0;
+                out.value[c.move]  = root_state.turn == 0 ? mean0 : 1.0 - mean0;
+            }
+        }
+
+       private:
+        NodeArena<Node> arena;
+        uint64_t rng = 1;
+        static const int max_depth = 64;
+        uint32_t path[max_depth];
+
+        uint64_t next() {
+            rng ^= rng << 13;
+            rng ^= rng >> 7;
+            rng ^= rng << 17;
+            return rng;
+        }
+
+        void iterate(uint32_t root) {
+            int depth      = 0;
+            uint32_t n     = root;
+            double result0 = 0.0;
+            path[depth++]  = n;
+            while (true) {
+                Node &node = arena[n];
+                if (node.state.is_over()) {
+                    result0 = outcome0(node.state);
+                    break;
+                }
+                if (depth == max_depth) {
+                    result0 = playout(node.state, node.roll);
+                    break;
+                }
+                if (node.roll != 0) {
+                    if (node.visits == 0 && n != root) {
+                        result0 = playout(node.state, node.roll);
+                        break;
+                    }
+                    if (node.first_child == UINT32_MAX && !expand_decision(n)) {
+                        result0 = playout(node.state, node.roll);
+                        break;
+                    }
+                    n = select(n);
+                } else {
+                    if (node.first_child == UINT32_MAX && !expand_chance(n)) {
+                        result0 = playout(node.state, 0);
+                        break;
+                    }
+                    n = arena[n].first_child + static_cast<uint32_t>(next() % sides);
+                }
+                path[depth++] = n;
+            }
+            for (int i = 0; i < depth; ++i) {
+                arena[path[i]].visits++;
+                arena[path[i]].wins0 += result0;
+            }
+        }
+
+        bool expand_decision(uint32_t n) {
+            const GameState &s = arena[n].state;
+            uint8_t open[cols];
+            uint32_t count = 0;
+            for (uint8_t col = 0; col < cols; ++col) {
+                if (!s.column_full(s.turn, col))
+                    open[count++] = col;
+            }
+            uint32_t first = arena.allocate(count);
+            if (first == UINT32_MAX)
+                return false;
+            Node &node       = arena[n];
+            node.first_child = first;
+            node.child_count = static_cast<uint8_t>(count);
+            for (uint32_t i = 0; i < count; ++i) {
+                Node &child = arena[first + i];
+                child.state = node.state;
+                child.state.place(open[i], node.roll);
+                child.move = open[i];
+            }
+            return true;
+        }
+
+        bool expand_chance(uint32_t n) {
+            uint32_t first = arena.allocate(sides);
+            if (first == UINT32_MAX)
+                return false;
+            Node &node       = arena[n];
+            node.first_child = first;
+            node.child_count = sides;
+            for (uint32_t i = 0; i < sides; ++i) {
+                arena[first + i].state = node.state;
+                arena[first + i].roll  = static_cast<uint8_t>(i + 1);
+            }
+            return true;
+        }
+
+        // UCT from the point of view of the player placing the die
+        uint32_t select(uint32_t n) {
+            const Node &node = arena[n];
+            double log_n      = std::log(static_cast<double>(node.visits) + 1.0);
+            uint32_t best     = node.first_child;
+            double best_score = -1.0;
+            for (uint32_t i = 0; i < node.child_count; ++i) {
+                const Node &c = arena[node.first_child + i];
+                if (c.visits == 0)
+                    return node.first_child + i;
+                double mean  = c.wins0 / c.visits;
+                double score = (node.state.turn == 0 ? mean : 1.0 - mean) + exploration * std::sqrt(log_n / c.visits);
+                if (score > best_score) {
+                    best_score = score;
+                    best       = node.first_child + i;
+                }
+            }
+            return best;
+        }
+
+        // Random game to the end; roll 0 means the side to move still has to roll
+        double playout(GameState s, int roll) {
+            while (!s.is_over()) {
+                if (roll == 0)
+                    roll = static_cast<int>(next() % sides) + 1;
+                int col = static_cast<int>(next() % cols);
+                while (s.column_full(s.turn, col))
+                    col = (col + 1) % cols;
+                s.place(col, roll);
+                roll = 0;
+            }
+            return outcome0(s);
+        }
+
+        static double outcome0(const GameState &s) {
+            int a = s.score(0), b = s.score(1);
+            return a > b ? 1.0 : (a == b ? 0.5 : 0.0);
+        }
+
+        static constexpr double exploration = 0.7;
+    };
+
+    std::vector<Search> searches;  // one per thread, kept between moves
+};
@@ -0,0 +1,90 @@
+#include "boardState.hpp"    // compact game state
+#include "fractionClass.hpp" // exact fractions
+#include "oddsClass.hpp"     // exact odds engine
+#include <chrono>            // timing
+#include <cstdio>            // printf
+#include <cstdlib>           // strtoul
+#include <iostream>          // input/output
+#include <string>            // string data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Exact Odds
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Prints the exact chances of a player 1 win, a tie and a player 2 win
+*        from a position under optimal play, as reduced fractions, along with
+*        the exact best column for every roll. The position is then solved
+*        again on one thread to confirm the fractions are identical.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o odds odds.cpp boardVariants.cpp`
+*        - Run with `./odds <p1_board> <p2_board> [turn] [threads] [max_states]`
+*        - Boards are 9 characters, column by column, '.' for empty (as in solver);
+*          turn is 1 or 2, the player to move.
+*        - e.g. `./odds 66.34512. 1..556163`
+*
+*  Files:             odds.cpp          : driver program
+*                     oddsClass.hpp     : exact odds engine
+*                     fractionClass.hpp : PO1's Fraction over wide integers
+*****************************************************************************/
+
+void print_odds(const char *label, const Fraction &f) {
+    std::cout << label << f << "  (" << f.to_double() << ")" << std::endl;
+}
+
+int main(int argc, char **argv) {
+    if (argc < 3) {
+        std::cerr << "usage: " << argv[0] << " <p1_board> <p2_board> [turn] [threads] [max_states]" << std::endl;
+        return 1;
+    }
+    GameState root;
+    if (!root.parse_board(0, argv[1]) || !root.parse_board(1, argv[2])) {
+        std::cerr << "boards must be " << GameState::rows * GameState::cols << " characters of '.' or 1-"
+                  << GameState::sides << std::endl;
+        return 1;
+    }
+    root.turn         = static_cast<uint8_t>(argc > 3 && std::string(argv[3]) == "2" ? 1 : 0);
+    unsigned threads  = argc > 4 ? static_cast<unsigned>(std::strtoul(argv[4], nullptr, 10)) : 0;
+    size_t max_states = argc > 5 ? std::strtoul(argv[5], nullptr, 10) : 2000000;
+
+    ExactOdds engine(threads, max_states);
+    auto start = std::chrono::steady_clock::now();
+    if (!engine.solve(root)) {
+        if (engine.rounds() > ExactOdds::max_rounds)
+            std::cerr << "policy iteration did not settle in " << ExactOdds::max_rounds << " rounds" << std::endl;
+        else
+            std::cerr << "more than " << max_states << " reachable states, raise max_states or pick a later position" << std::endl;
+        return 1;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << root.to_string();
+    std::printf("%zu states, largest removal cycle %zu, %d policy rounds, %.3fs\n", engine.states(),
+                engine.largest_cycle(), engine.rounds(), secs);
+    Odds odds = engine.odds(root);
+    print_odds("player 1 wins: ", odds.p1_win);
+    print_odds("tie:           ", odds.tie);
+    print_odds("player 2 wins: ", odds.p2_win);
+    if (!root.is_over()) {
+        for (int roll = 1; roll <= GameState::sides; ++roll) {
+            int col         = engine.best_move(root, roll);
+            GameState after = root;
+            after.place(col, roll);
+            std::cout << "roll " << roll << " -> column " << col + 1 << ", value "
+                      << Fraction(1) - engine.value(after) << std::endl;
+        }
+    }
+
+    // the same position on one thread must give the same fractions
+    ExactOdds single(1, max_states);
+    single.solve(root);
+    Odds again = single.odds(root);
+    bool same  = again.p1_win == odds.p1_win && again.tie == odds.tie && again.p2_win == odds.p2_win;
+    std::cout << "1 thread: " << (same ? "identical" : "DIFFERENT") << std::endl;
+    return same ? 0 : 1;
+}
@@ -0,0 +1,620 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "boardState.hpp"
+#include "fractionClass.hpp"
+#include "solverClass.hpp"
+
+/**
+ * Odds
+ *
+ * Description:
+ *      Exact chances of each result, always from player 1's side, so the
+ *      three always add up to exactly 1.
+ */
+struct Odds {
+    Fraction p1_win;
+    Fraction tie;
+    Fraction p2_win;
+};
+
+/**
+ * ExactOdds
+ *
+ * Description:
+ *      Exact rational win / tie / loss probabilities under optimal play, for
+ *      publishing odds that do not depend on floating point. Optimal means
+ *      each side maximises P(win) + P(tie) / 2, as in the Solver. Among
+ *      columns with exactly the same value the lowest canonical column is
+ *      played, so the win/tie split is defined too.
+ *
+ *      Every position reachable from the root is stored once per column
+ *      permutation, which memoises the work. A move never lowers the number
+ *      of dice on the boards, so positions are solved from the fullest layer
+ *      down. Removals can lead back to a position within a layer. Those
+ *      cycles are found as strongly connected components (Tarjan) of the
+ *      layer under the current policy, and each component is solved exactly
+ *      by sparse Gaussian elimination on wide integers (each row has at most six
+ *      moves, so pivots are picked to keep it sparse), with fractions only in
+ *      the back substitution. Components that do not depend on each other are
+ *      solved in parallel.
+ *
+ *      Play starts from the floating-point Solver's choices, then exact
+ *      policy iteration switches moves with a strictly better exact value
+ *      until none is left. Switching both players at once can cycle in a
+ *      stochastic game, so the sides take turns (Hoffman-Karp): player 2's
+ *      moves are improved until they are a best reply to player 1's, then
+ *      player 1 improves once against that reply, and so on. Each player 1
+ *      step strictly raises its value, so this ends; as a guard, solve gives
+ *      up after max_rounds evaluations. Every value is a reduced fraction
+ *      computed by a fixed formula, so results are bit-identical for any
+ *      thread count.
+ *
+ * Public Methods:
+ *      - ExactOdds(unsigned threads = 0, size_t max_states = 2000000)
+ *      - bool solve(const GameState& root)             : False if more than max_states positions are reachable,
+ *                                                        or play has not settled after max_rounds evaluations.
+ *      - Odds odds(const GameState& s) const           : Any position reachable from the root, or a finished game.
+ *      - Fraction value(const GameState& s) const      : P(win) + P(tie) / 2 for the side to move.
+ *      - int best_move(const GameState& s, int roll) const : Column in `s`, -1 if none.
+ *      - size_t states() const / size_t largest_cycle() const / int rounds() const
+ *
+ * Usage:
+ *      ExactOdds engine;
+ *      if (engine.solve(position)) std::cout << engine.odds(position).p1_win << std::endl;
+ */
+class ExactOdds {
+   public:
+    static constexpr int max_rounds = 500;  // policy evaluations before solve gives up
+
+    ExactOdds(unsigned threads = 0, size_t max_states = 2000000) : max_states(max_states) {
+        thread_count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    bool solve(const GameState &root) {
+        keys.clear();
+        index.clear();
+        if (root.is_over())
+            return true;
+        if (!enumerate(root))
+            return false;
+        link();
+
+        // start from the floating-point solver's choices
+        Solver solver(thread_count, max_states);
+        SolutionTable table;
+        if (!solver.solve(root, table))
+            return false;
+        policy.assign(keys.size() * sides, 0);
+        parallel_for(keys.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                GameState s = GameState::from_key(keys[i]);
+                for (int roll = 1; roll <= sides; ++roll)
+                    policy[i * sides + roll - 1] = static_cast<uint8_t>(table.best_move(s, roll));
+            }
+        });
+
+        // Hoffman-Karp: player 2's best reply to player 1's policy is found
+        // to a fixed point before player 1 switches anything
+        policy_rounds = 0;
+        do {
+            do {
+                if (++policy_rounds > max_rounds)
+                    return false;
+                evaluate();
+            } while (improve(false, 1));
+        } while (improve(false, 0));
+        // settle exact ties on the lowest column; values stay the same
+        if (improve(true, -1))
+            evaluate();
+        return true;
+    }
+
+    Odds odds(const GameState &s) const {
+        if (s.is_over()) {
+            int code = result_code(s);
+            return Odds{Fraction(code == p1_won), Fraction(code == tied), Fraction(code == p2_won)};
+        }
+        auto it = index.find(s.canonical().key);
+        if (it == index.end())
+            return Odds{Fraction(0), Fraction(0), Fraction(0)};
+        const Fraction &w = win[it->second];
+        const Fraction &t = tie[it->second];
+        return Odds{w, t, Fraction(1) - w - t};
+    }
+
+    Fraction value(const GameState &s) const {
+        Odds o = odds(s);
+        return (s.turn == 0 ? o.p1_win : o.p2_win) + o.tie * Fraction(1, 2);
+    }
+
+    int best_move(const GameState &s, int roll) const {
+        CanonicalKey c = s.canonical();
+        auto it        = index.find(c.key);
+        if (it == index.end())
+            return -1;
+        return c.to_original(policy[it->second * sides + roll - 1]);
+    }
+
+    size_t states() const { return keys.size(); }
+    size_t largest_cycle() const { return biggest_component; }
+    int rounds() const { return policy_rounds; }
+
+   private:
+    static constexpr int sides    = GameState::sides;
+    static constexpr int cols     = GameState::cols;
+    static constexpr int max_dice = 2 * GameState::rows * GameState::cols;
+    // child codes below zero: the move ended the game, or was not legal
+    static constexpr int32_t p1_won     = -1;
+    static constexpr int32_t tied       = -2;
+    static constexpr int32_t p2_won     = -3;
+    static constexpr int32_t illegal    = -4;
+    static constexpr uint32_t unvisited = 0xFFFFFFFFu;
+
+    unsigned thread_count;
+    size_t max_states;
+    std::vector<uint64_t> keys;                    // canonical keys of unfinished positions
+    std::unordered_map<uint64_t, uint32_t> index;  // key -> position in keys
+    std::vector<uint8_t> dice;                     // dice on the boards, per position
+    std::vector<uint8_t> turn;                     // side to move, per position
+    std::vector<int32_t> child;                    // [position][roll][column] -> index or result code
+    std::vector<uint8_t> policy;                   // [position][roll] -> canonical column
+    std::vector<Fraction> win;                     // P(player 1 wins), per position
+    std::vector<Fraction> tie;                     // P(tie), per position
+    std::vector<Fraction> to_move;                 // P(win) + P(tie) / 2 for the side to move
+    size_t biggest_component = 0;
+    int policy_rounds        = 0;
+    struct Entry {
+        uint32_t col;
+        WideInt v;
+    };
+    using Row = std::vector<Entry>;  // sparse equation, sorted by column
+
+    // per-position scratch for finding components, reused across layers
+    std::vector<uint32_t> order, low;
+    std::vector<int32_t> comp_of;
+    std::vector<uint8_t> on_stack;
+
+    static int32_t result_code(const GameState &s) {
+        int a = s.score(0), b = s.score(1);
+        return a > b ? p1_won : (a == b ? tied : p2_won);
+    }
+
+    bool enumerate(const GameState &root) {
+        std::vector<uint64_t> frontier = {root.canonical().key};
+        index[frontier[0]]             = 0;
+        keys.push_back(frontier[0]);
+        while (!frontier.empty()) {
+            std::vector<std::vector<uint64_t> > found(thread_count);
+            parallel_for(frontier.size(), [&](size_t begin, size_t end, unsigned t) {
+                std::unordered_set<uint64_t> local;
+                for (size_t i = begin; i < end; ++i) {
+                    GameState s = GameState::from_key(frontier[i]);
+                    for (int roll = 1; roll <= sides; ++roll) {
+                        for (int col = 0; col < cols; ++col) {
+                            if (s.column_full(s.turn, col))
+                                continue;
+                            GameState next = s;
+                            next.place(col, roll);
+                            if (!next.is_over())
+                                local.insert(next.canonical().key);
+                        }
+                    }
+                }
+                found[t].assign(local.begin(), local.end());
+            });
+            frontier.clear();
+            for (const auto &part : found) {
+                for (uint64_t k : part) {
+                    if (index.count(k))
+                        continue;
+                    if (keys.size() >= max_states)
+                        return false;
+                    index[k] = static_cast<uint32_t>(keys.size());
+                    keys.push_back(k);
+                    frontier.push_back(k);
+                }
+            }
+        }
+        return true;
+    }
+
+    // Records where every roll and column leads, in the canonical column order of each position
+    void link() {
+        dice.assign(keys.size(), 0);
+        turn.assign(keys.size(), 0);
+        child.assign(keys.size() * sides * cols, illegal);
+        parallel_for(keys.size(), [&](size_t begin, size_t end, unsigned) {
+            for (size_t i = begin; i < end; ++i) {
+                GameState s = GameState::from_key(keys[i]);
+                dice[i]     = static_cast<uint8_t>(s.dice_count());
+                turn[i]     = s.turn;
+                for (int roll = 1; roll <= sides; ++roll) {
+                    for (int col = 0; col < cols; ++col) {
+                        if (s.column_full(s.turn, col))
+                            continue;
+                        GameState next = s;
+                        next.place(col, roll);
+                        child[(i * sides + roll - 1) * cols + col] =
+                            next.is_over() ? result_code(next) : static_cast<int32_t>(index.at(next.canonical().key));
+                    }
+                }
+            }
+        });
+    }
+
+    int32_t next_under_policy(size_t i, int roll_idx) const {
+        return child[(i * sides + roll_idx) * cols + policy[i * sides + roll_idx]];
+    }
+
+    // Exact P(player 1 wins) and P(tie) for every position under the current policy
+    void evaluate() {
+        win.assign(keys.size(), Fraction(0));
+        tie.assign(keys.size(), Fraction(0));
+        biggest_component = 0;
+        std::vector<std::vector<uint32_t> > layers(max_dice + 1);
+        for (size_t i = 0; i < keys.size(); ++i)
+            layers[dice[i]].push_back(static_cast<uint32_t>(i));
+        order.assign(keys.size(), unvisited);
+        low.assign(keys.size(), 0);
+        on_stack.assign(keys.size(), 0);
+        comp_of.assign(keys.size(), -1);
+
+        for (int d = max_dice; d >= 0; --d) {
+            std::vector<std::vector<uint32_t> > components = strongly_connected(layers[d]);
+            // a component's rank is one more than the highest rank it moves into,
+            // so components of one rank never depend on each other
+            std::vector<int> rank(components.size(), 0);
+            for (size_t c = 0; c < components.size(); ++c)
+                for (uint32_t i : components[c])
+                    comp_of[i] = static_cast<int32_t>(c);
+            int top = 0;
+            for (size_t c = 0; c < components.size(); ++c) {
+                for (uint32_t i : components[c]) {
+                    for (int r = 0; r < sides; ++r) {
+                        int32_t n = next_under_policy(i, r);
+                        if (n >= 0 && dice[n] == d && comp_of[n] != static_cast<int32_t>(c))
+                            rank[c] = std::max(rank[c], rank[comp_of[n]] + 1);
+                    }
+                }
+                top               = std::max(top, rank[c]);
+                biggest_component = std::max(biggest_component, components[c].size());
+            }
+            std::vector<std::vector<size_t> > by_rank(top + 1);
+            for (size_t c = 0; c < components.size(); ++c)
+                by_rank[rank[c]].push_back(c);
+            for (const auto &group : by_rank) {
+                parallel_for(group.size(), [&](size_t begin, size_t end, unsigned) {
+                    for (size_t g = begin; g < end; ++g)
+                        solve_component(components[group[g]]);
+                });
+            }
+        }
+
+        to_move.assign(keys.size(), Fraction(0));
+        parallel_for(keys.size(), [&](size_t begin, size_t end, unsigned) {
+            const Fraction half(1, 2);
+            for (size_t i = begin; i < end; ++i) {
+                Fraction mine = turn[i] == 0 ? win[i] : Fraction(1) - win[i] - tie[i];
+                to_move[i]    = mine + tie[i] * half;
+            }
+        });
+    }
+
+    // Tarjan's algorithm over moves that stay in the layer, without recursion.
+    // Components come out with everything they move into already listed.
+    std::vector<std::vector<uint32_t> > strongly_connected(const std::vector<uint32_t> &layer) {
+        std::vector<std::vector<uint32_t> > out;
+        std::vector<uint32_t> stack;
+        std::vector<std::pair<uint32_t, int> > calls;  // position, next roll to follow
+        uint32_t counter = 0;
+        for (uint32_t start : layer) {
+            if (order[start] != unvisited)
+                continue;
+            calls.push_back({start, 0});
+            while (!calls.empty()) {
+                uint32_t v = calls.back().first;
+                int &r     = calls.back().second;
+                if (r == 0 && order[v] == unvisited) {
+                    order[v] = low[v] = counter++;
+                    stack.push_back(v);
+                    on_stack[v] = 1;
+                }
+                bool descended = false;
+                while (r < sides && !descended) {
+                    int32_t n = next_under_policy(v, r++);
+                    if (n < 0 || dice[n] != dice[v])
+                        continue;
+                    uint32_t w = static_cast<uint32_t>(n);
+                    if (order[w] == unvisited) {
+                        calls.push_back({w, 0});
+                        descended = true;
+                    } else if (on_stack[w]) {
+                        low[v] = std::min(low[v], order[w]);
+                    }
+                }
+                if (descended)
+                    continue;
+                if (low[v] == order[v]) {
+                    std::vector<uint32_t> comp;
+                    uint32_t w;
+                    do {
+                        w = stack.back();
+                        stack.pop_back();
+                        on_stack[w] = 0;
+                        comp.push_back(w);
+                    } while (w != v);
+                    out.push_back(std::move(comp));
+                }
+                calls.pop_back();
+                if (!calls.empty())
+                    low[calls.back().first] = std::min(low[calls.back().first], low[v]);
+            }
+        }
+        return out;
+    }
+
+    // Solves x_i = 1/6 * sum over rolls of x_next for every position of one component
+    void solve_component(const std::vector<uint32_t> &comp) {
+        const Fraction sixth(1, sides);
+        size_t k = comp.size();
+        if (k == 1) {
+            Fraction w(0), t(0);
+            for (int r = 0; r < sides; ++r) {
+                int32_t n = next_under_policy(comp[0], r);
+                if (n == p1_won)
+                    w += Fraction(1);
+                else if (n == tied)
+                    t += Fraction(1);
+                else if (n >= 0) {
+                    w += win[n];
+                    t += tie[n];
+                }
+            }
+            win[comp[0]] = w * sixth;
+            tie[comp[0]] = t * sixth;
+            return;
+        }
+
+        std::unordered_map<uint32_t, uint32_t> local;
+        for (size_t j = 0; j < k; ++j)
+            local[comp[j]] = static_cast<uint32_t>(j);
+        // Row j: 6 x_j - (x of the in-component positions it moves to) = results of
+        // the other moves. Rows are sparse, columns k and k + 1 hold the win and
+        // tie right-hand sides over one common denominator.
+        const uint32_t rhs_win = static_cast<uint32_t>(k), rhs_tie = rhs_win + 1;
+        std::vector<Row> rows(k);
+        std::vector<Fraction> rhs(2 * k, Fraction(0));
+        for (size_t j = 0; j < k; ++j) {
+            rows[j].push_back({static_cast<uint32_t>(j), WideInt(sides)});
+            for (int r = 0; r < sides; ++r) {
+                int32_t n = next_under_policy(comp[j], r);
+                auto it   = n >= 0 ? local.find(static_cast<uint32_t>(n)) : local.end();
+                if (it != local.end())
+                    add_entry(rows[j], it->second, WideInt(-1));
+                else if (n == p1_won)
+                    rhs[2 * j] += Fraction(1);
+                else if (n == tied)
+                    rhs[2 * j + 1] += Fraction(1);
+                else if (n >= 0) {
+                    rhs[2 * j] += win[n];
+                    rhs[2 * j + 1] += tie[n];
+                }
+            }
+        }
+        WideInt common = 1;
+        for (const Fraction &f : rhs)
+            common = common / WideInt::gcd(common, f.denominator()) * f.denominator();
+        for (size_t j = 0; j < k; ++j) {
+            for (uint32_t which = 0; which < 2; ++which) {
+                const Fraction &f = rhs[2 * j + which];
+                if (!f.numerator().is_zero())
+                    rows[j].push_back({rhs_win + which, f.numerator() * (common / f.denominator())});
+            }
+        }
+
+        // Sparse elimination. Each step pivots on the remaining row with the
+        // fewest unknowns, at its column shared by the fewest rows, which keeps
+        // fill-in low; rows are divided by their content to keep numbers small.
+        std::vector<std::vector<uint32_t> > rows_with(k);
+        std::vector<uint32_t> col_count(k, 0);
+        for (uint32_t j = 0; j < k; ++j) {
+            for (const Entry &e : rows[j]) {
+                if (e.col < rhs_win) {
+                    rows_with[e.col].push_back(j);
+                    ++col_count[e.col];
+                }
+            }
+        }
+        std::vector<uint8_t> row_done(k, 0);
+        std::vector<size_t> touched(k, k);
+        std::vector<std::pair<uint32_t, uint32_t> > pivots;  // (row, column) in elimination order
+        for (size_t step = 0; step < k; ++step) {
+            uint32_t pr = 0;
+            size_t fewest = SIZE_MAX;
+            for (uint32_t j = 0; j < k; ++j) {
+                if (!row_done[j] && unknowns(rows[j], rhs_win) < fewest) {
+                    fewest = unknowns(rows[j], rhs_win);
+                    pr     = j;
+                }
+            }
+            uint32_t pc = rhs_win;
+            for (const Entry &e : rows[pr]) {
+                if (e.col < rhs_win && (pc == rhs_win || col_count[e.col] < col_count[pc]))
+                    pc = e.col;
+            }
+            row_done[pr] = 1;
+            pivots.push_back({pr, pc});
+            for (const Entry &e : rows[pr]) {
+                if (e.col < rhs_win)
+                    --col_count[e.col];
+            }
+            const WideInt &p = find_entry(rows[pr], pc)->v;
+            for (uint32_t q : rows_with[pc]) {
+                if (row_done[q] || touched[q] == step)
+                    continue;
+                touched[q]      = step;
+                const Entry *at = find_entry(rows[q], pc);
+                if (!at)
+                    continue;
+                // q = (p / g) q - (a / g) pivot_row, which cancels column pc
+                WideInt g  = WideInt::gcd(p, at->v);
+                WideInt mq = p / g, mp = at->v / g;
+                for (const Entry &e : rows[q]) {
+                    if (e.col < rhs_win)
+                        --col_count[e.col];
+                }
+                Row merged;
+                size_t a = 0, b = 0;
+                const Row &x = rows[q], &y = rows[pr];
+                while (a < x.size() || b < y.size()) {
+                    uint32_t c = std::min(a < x.size() ? x[a].col : UINT32_MAX, b < y.size() ? y[b].col : UINT32_MAX);
+                    WideInt v  = 0;
+                    bool had_q = a < x.size() && x[a].col == c;
+                    if (had_q)
+                        v = x[a++].v * mq;
+                    if (b < y.size() && y[b].col == c)
+                        v -= y[b++].v * mp;
+                    if (c == pc || v.is_zero())
+                        continue;
+                    if (!had_q && c < rhs_win)
+                        rows_with[c].push_back(q);
+                    merged.push_back({c, std::move(v)});
+                }
+                remove_content(merged);
+                for (const Entry &e : merged) {
+                    if (e.col < rhs_win)
+                        ++col_count[e.col];
+                }
+                rows[q] = std::move(merged);
+            }
+        }
+
+        // back substitution in reverse order; y = common * x
+        std::vector<Fraction> y_win(k, Fraction(0)), y_tie(k, Fraction(0));
+        for (size_t i = pivots.size(); i-- > 0;) {
+            const Row &row = rows[pivots[i].first];
+            uint32_t pc    = pivots[i].second;
+            Fraction w(0), t(0), p(1);
+            for (const Entry &e : row) {
+                if (e.col == pc)
+                    p = Fraction(e.v);
+                else if (e.col == rhs_win)
+                    w += Fraction(e.v);
+                else if (e.col == rhs_tie)
+                    t += Fraction(e.v);
+                else {
+                    w -= Fraction(e.v) * y_win[e.col];
+                    t -= Fraction(e.v) * y_tie[e.col];
+                }
+            }
+            y_win[pc] = w / p;
+            y_tie[pc] = t / p;
+        }
+        const Fraction scale(WideInt(1), common);
+        for (size_t j = 0; j < k; ++j) {
+            win[comp[j]] = y_win[j] * scale;
+            tie[comp[j]] = y_tie[j] * scale;
+        }
+    }
+
+    static size_t unknowns(const Row &row, uint32_t rhs_col) {
+        size_t n = 0;
+        while (n < row.size() && row[n].col < rhs_col)
+            ++n;
+        return n;
+    }
+
+    static const Entry *find_entry(const Row &row, uint32_t col) {
+        auto it = std::lower_bound(row.begin(), row.end(), col, [](const Entry &e, uint32_t c) { return e.col < c; });
+        return it != row.end() && it->col == col ? &*it : nullptr;
+    }
+
+    // Adds `v` at `col`, keeping the row sorted by column
+    static void add_entry(Row &row, uint32_t col, const WideInt &v) {
+        auto it = std::lower_bound(row.begin(), row.end(), col, [](const Entry &e, uint32_t c) { return e.col < c; });
+        if (it != row.end() && it->col == col) {
+            it->v += v;
+            if (it->v.is_zero())
+                row.erase(it);
+        } else {
+            row.insert(it, {col, v});
+        }
+    }
+
+    // Divides a row by the gcd of its entries; stops looking once the gcd is 1
+    static void remove_content(Row &row) {
+        if (row.empty())
+            return;
+        WideInt g = row[0].v;
+        for (size_t i = 1; i < row.size() && !(g == WideInt(1) || g == WideInt(-1)); ++i)
+            g = WideInt::gcd(g, row[i].v);
+        if (g.negative())
+            g = -g;
+        if (g == WideInt(1))
+            return;
+        for (Entry &e : row)
+            e.v /= g;
+    }
+
+    // Value for the side to move after `n`; the mover wants it as low as possible
+    const Fraction &reply_value(int32_t n, int mover) const {
+        static const Fraction zero(0), half(1, 2), one(1);
+        if (n == tied)
+            return half;
+        if (n < 0)
+            return (n == p1_won) == (mover == 0) ? zero : one;
+        return to_move[n];
+    }
+
+    // Switches moves that are strictly worse than the best exact value, or with
+    // `settle_ties` any move that is not the lowest best column. True if any changed.
+    // Switches moves of `side` (-1 for both) to strictly better ones; true if any changed
+    bool improve(bool settle_ties, int side) {
+        std::vector<uint8_t> changed(thread_count, 0);
+        parallel_for(keys.size(), [&](size_t begin, size_t end, unsigned t) {
+            for (size_t i = begin; i < end; ++i) {
+                if (side >= 0 && turn[i] != side)
+                    continue;
+                for (int r = 0; r < sides; ++r) {
+                    uint8_t &chosen = policy[i * sides + r];
+                    int best_col         = chosen;
+                    const Fraction *best = &reply_value(child[(i * sides + r) * cols + chosen], turn[i]);
+                    for (int col = 0; col < cols; ++col) {
+                        int32_t n = child[(i * sides + r) * cols + col];
+                        if (n == illegal || col == chosen)
+                            continue;
+                        const Fraction &v = reply_value(n, turn[i]);
+                        if (v < *best || (settle_ties && v == *best && col < best_col)) {
+                            best     = &v;
+                            best_col = col;
+                        }
+                    }
+                    if (best_col != chosen) {
+                        chosen     = static_cast<uint8_t>(best_col);
+                        changed[t] = 1;
+                    }
+                }
+            }
+        });
+        return std::find(changed.begin(), changed.end(), 1) != changed.end();
+    }
+
+    template <typename Fn>
+    void parallel_for(size_t n, Fn fn) const {
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(thread_count, std::max<size_t>(n, 1)));
+        size_t chunk     = (n + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < workers; ++t)
+            pool.emplace_back(fn, std::min(n, t * chunk), std::min(n, (t + 1) * chunk), t);
+        fn(0, std::min(n, chunk), 0u);
+        for (auto &th : pool)
+            th.join();
+    }
+};
@@ -0,0 +1,147 @@
+#include "boardState.hpp"  // compact game state and rules
+#include "perftClass.hpp"  // enumeration
+#include <chrono>          // timing
+#include <cstdio>          // printf
+#include <cstdlib>         // strtoul
+#include <string>          // string data structure
+#include <vector>          // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Perft
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Walks every roll and column sequence from a position to a fixed depth
+*        and prints, per depth, how many sequences there are, how many ended
+*        with a removal or a finished game, the results of finished games and
+*        the total score. Run without a position it first checks a set of
+*        reference positions against known counts, then times the walk from
+*        the empty boards as a benchmark of the rules.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o perft perft.cpp boardVariants.cpp`
+*        - Run with `./perft [depth] [threads] [p1_board p2_board [turn]]`
+*        - Boards are 9 characters, column by column, '.' for empty (as in solver);
+*          turn is 1 or 2, the player to move.
+*        - e.g. `./perft 7` checks the references, then benchmarks depth 7
+*
+*  Files:             perft.cpp         : driver and reference counts
+*                     perftClass.hpp    : parallel enumeration
+*                     boardState.hpp    : the rules being checked
+*****************************************************************************/
+
+struct Reference {
+    const char *name;
+    const char *p1;
+    const char *p2;
+    int turn;
+    std::vector<PerftLevel> levels;  // {nodes, removals, terminal, p1_wins, ties, score_total} per depth
+};
+
+// Counts from a separate, deliberately simple implementation of the rules
+const std::vector<Reference> references = {
+    {"start", ".........", ".........", 0,
+     {{1, 0, 0, 0, 0, 0},
+      {18, 0, 0, 0, 0, 63},
+      {324, 18, 0, 0, 0, 2205},
+      {5832, 324, 0, 0, 0, 61110},
+      {104976, 11034, 0, 0, 0, 1465191},
+      {1889568, 198612, 0, 0, 0, 33604830},
+      {34012224, 5083596, 0, 0, 0, 728495334}}},
+    {"middle", "6..34.1..", "2..55.3..", 0,
+     {{1, 0, 0, 0, 0, 39},
+      {18, 3, 0, 0, 0, 773},
+      {324, 86, 0, 0, 0, 15239},
+      {5280, 1101, 0, 0, 0, 269300},
+      {85584, 24896, 0, 0, 0, 4674233},
+      {1241028, 312407, 0, 0, 0, 72203717}}},
+    {"late", "66.34512.", "1..556163", 0,
+     {{1, 0, 0, 0, 0, 76},
+      {12, 4, 0, 0, 0, 973},
+      {90, 25, 0, 0, 0, 7332},
+      {654, 234, 390, 377, 1, 55892},
+      {2022, 638, 450, 49, 18, 161832},
+      {11520, 4228, 6462, 4782, 62, 960243}}},
+    {"removals", "6615.4.22", "3316.2.45", 1,
+     {{1, 0, 0, 0, 0, 72},
+      {12, 3, 0, 0, 0, 925},
+      {144, 56, 0, 0, 0, 11631},
+      {1056, 343, 528, 309, 21, 88942},
+      {4512, 1806, 1476, 1371, 19, 372603},
+      {22872, 7905, 10872, 6640, 379, 1907031},
+      {97596, 39146, 37932, 35084, 468, 8044538}}},
+};
+
+void print_levels(const std::vector<PerftLevel> &levels) {
+    std::printf("%5s %14s %12s %10s %10s %8s %16s\n", "depth", "nodes", "removals", "terminal", "p1_wins", "ties",
+                "score_total");
+    for (size_t d = 0; d < levels.size(); ++d) {
+        const PerftLevel &l = levels[d];
+        std::printf("%5zu %14llu %12llu %10llu %10llu %8llu %16llu\n", d, static_cast<unsigned long long>(l.nodes),
+                    static_cast<unsigned long long>(l.removals), static_cast<unsigned long long>(l.terminal),
+                    static_cast<unsigned long long>(l.p1_wins), static_cast<unsigned long long>(l.ties),
+                    static_cast<unsigned long long>(l.score_total));
+    }
+}
+
+// Runs `perft` and reports the node rate; returns the levels
+std::vector<PerftLevel> timed_run(Perft<GameState> &perft, const GameState &root, int depth) {
+    auto start                     = std::chrono::steady_clock::now();
+    std::vector<PerftLevel> levels = perft.run(root, depth);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t total = 0;
+    for (const PerftLevel &l : levels)
+        total += l.nodes;
+    print_levels(levels);
+    std::printf("%llu nodes in %.3fs, %.1f M nodes/s\n", static_cast<unsigned long long>(total), secs,
+                total / secs / 1e6);
+    return levels;
+}
+
+int main(int argc, char **argv) {
+    int depth        = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 7;
+    unsigned threads = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+    Perft<GameState> perft(threads);
+
+    if (argc > 4) {
+        GameState root;
+        if (!root.parse_board(0, argv[3]) || !root.parse_board(1, argv[4])) {
+            std::fprintf(stderr, "boards must be %d characters of '.' or 1-%d\n", GameState::rows * GameState::cols,
+                         GameState::sides);
+            return 1;
+        }
+        root.turn = static_cast<uint8_t>(argc > 5 && std::string(argv[5]) == "2" ? 1 : 0);
+        std::printf("%s", root.to_string().c_str());
+        timed_run(perft, root, depth);
+        return 0;
+    }
+
+    int failures = 0;
+    for (const Reference &ref : references) {
+        GameState root;
+        root.parse_board(0, ref.p1);
+        root.parse_board(1, ref.p2);
+        root.turn = static_cast<uint8_t>(ref.turn);
+        int ref_depth                  = static_cast<int>(ref.levels.size()) - 1;
+        std::vector<PerftLevel> levels = perft.run(root, ref_depth);
+        int bad                        = -1;
+        for (int d = 0; d <= ref_depth && bad < 0; ++d) {
+            if (!(levels[d] == ref.levels[d]))
+                bad = d;
+        }
+        std::printf("%-9s depth %d: %s\n", ref.name, ref_depth, bad < 0 ? "ok" : "MISMATCH");
+        if (bad >= 0) {
+            ++failures;
+            std::printf("first wrong depth is %d, got:\n", bad);
+            print_levels(levels);
+        }
+    }
+
+    std::printf("\nstart position, depth %d:\n", depth);
+    timed_run(perft, GameState(), depth);
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "boardState.hpp"
+
+/**
+ * PerftLevel
+ *
+ * Description:
+ *      Totals for every move sequence of one length. `nodes` counts sequences
+ *      (a roll and a column per move), not distinct positions, so the numbers
+ *      depend on nothing but the rules and can be compared between versions.
+ */
+struct PerftLevel {
+    uint64_t nodes       = 0;  // move sequences of this length
+    uint64_t removals    = 0;  // of those, last move knocked out an opponent die
+    uint64_t terminal    = 0;  // of those, last move ended the game
+    uint64_t p1_wins     = 0;  // finished games won by player 1
+    uint64_t ties        = 0;  // finished games tied
+    uint64_t score_total = 0;  // sum of both players' scores over all nodes
+
+    void add(const PerftLevel &o) {
+        nodes += o.nodes;
+        removals += o.removals;
+        terminal += o.terminal;
+        p1_wins += o.p1_wins;
+        ties += o.ties;
+        score_total += o.score_total;
+    }
+
+    bool operator==(const PerftLevel &o) const {
+        return nodes == o.nodes && removals == o.removals && terminal == o.terminal && p1_wins == o.p1_wins &&
+               ties == o.ties && score_total == o.score_total;
+    }
+};
+
+/**
+ * ColumnScores
+ *
+ * Description:
+ *      Score of every raw column (read as a base Sides + 1 number, row 0
+ *      first, as in ColumnTables), so the walk scores a column with one load.
+ */
+template <int Rows, int Sides>
+struct ColumnScores {
+    using Tables = ColumnTables<Rows, Sides>;
+
+    int16_t score[Tables::raw_count()] = {};
+
+    constexpr ColumnScores() {
+        for (int raw = 0; raw < Tables::raw_count(); ++raw) {
+            int counts[Sides + 1] = {};
+            int total             = 0;
+            for (int rest = raw, row = 0; row < Rows; ++row, rest /= Tables::base) {
+                counts[rest % Tables::base]++;
+                total += rest % Tables::base;
+            }
+            for (int value = 1; value <= Sides; ++value) {
+                if (counts[value] > 1)
+                    total += (counts[value] - 1) * value * counts[value];
+            }
+            score[raw] = static_cast<int16_t>(total);
+        }
+    }
+};
+
+/**
+ * Perft
+ *
+ * Description:
+ *      Exhaustive enumeration of every roll and column sequence from a root to
+ *      a fixed depth, in the style of chess perft. Finished games are counted
+ *      and not expanded. The per-depth totals check place, removal and
+ *      scoring against known numbers, and the node rate is the throughput of
+ *      the rules engine.
+ *
+ *      The walk runs in place with make_move/unmake_move and keeps both scores
+ *      up to date from the one column a move touches, scored by table lookup. The sequences of the
+ *      first `split_depth` moves become tasks that worker threads take from a
+ *      shared counter. Each thread sums into its own levels and the results
+ *      are added at the end, so the totals do not depend on the thread count.
+ *
+ * Public Methods:
+ *      - Perft(unsigned threads = 0, int split_depth = 2)
+ *      - std::vector<PerftLevel> run(const State& root, int depth) : Entry d covers sequences of length d.
+ *
+ * Usage:
+ *      Perft<GameState> perft(4);
+ *      std::vector<PerftLevel> levels = perft.run(GameState(), 6);
+ *      uint64_t leaves = levels[6].nodes;
+ */
+template <typename State = GameState>
+class Perft {
+   public:
+    Perft(unsigned threads = 0, int split_depth = 2) : split_depth(split_depth) {
+        thread_count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    std::vector<PerftLevel> run(const State &root, int depth) {
+        std::vector<PerftLevel> levels(depth + 1);
+        levels[0].nodes       = 1;
+        levels[0].score_total = static_cast<uint64_t>(root.score(0) + root.score(1));
+        if (depth == 0 || root.is_over())
+            return levels;
+
+        // the first moves are walked here and their end positions handed out
+        std::vector<State> tasks;
+        int split = std::min(split_depth, depth);
+        collect(root, 0, split, levels, tasks);
+
+        std::atomic<size_t> next{0};
+        std::vector<std::vector<PerftLevel> > partial(thread_count);
+        auto worker = [&](unsigned t) {
+            // counted in a thread-local copy so workers never share a cache line
+            std::vector<PerftLevel> mine(depth + 1);
+            for (size_t i = next++; i < tasks.size(); i = next++) {
+                State s = tasks[i];
+                walk(s, split, depth, s.score(0), s.score(1), mine.data());
+            }
+            partial[t] = mine;
+        };
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < thread_count; ++t)
+            pool.emplace_back(worker, t);
+        worker(0);
+        for (auto &th : pool)
+            th.join();
+
+        for (const auto &part : partial)
+            for (size_t d = 0; d < part.size(); ++d)
+                levels[d].add(part[d]);
+        return levels;
+    }
+
+   private:
+    unsigned thread_count;
+    int split_depth;
+
+    // Counts the levels up to `split` and keeps the unfinished positions found there
+    void collect(const State &s, int ply, int split, std::vector<PerftLevel> &levels, std::vector<State> &tasks) {
+        for (int roll = 1; roll <= State::sides; ++roll) {
+            for (int col = 0; col < State::cols; ++col) {
+                if (s.column_full(s.turn, col))
+                    continue;
+                State child       = s;
+                auto undo         = child.make_move(col, roll);
+                PerftLevel &level = levels[ply + 1];
+                int s0            = child.score(0);
+                int s1            = child.score(1);
+                bool over         = child.board_full(s.turn);
+                level.nodes += 1;
+                level.removals += undo.removed_row >= 0;
+                level.score_total += static_cast<uint64_t>(s0 + s1);
+                if (over) {
+                    count_result(level, s0, s1);
+                } else if (ply + 1 == split) {
+                    tasks.push_back(child);
+                } else {
+                    collect(child, ply + 1, split, levels, tasks);
+                }
+            }
+        }
+    }
+
+    // Depth-first walk below `ply`; `s0`/`s1` are the current scores
+    static void walk(State &s, int ply, int depth, int s0, int s1, PerftLevel *levels) {
+        PerftLevel &level = levels[ply + 1];
+        const int mover   = s.turn;
+        for (int col = 0; col < State::cols; ++col) {
+            if (s.column_full(mover, col))
+                continue;
+            // both scores only change in this column
+            int before0 = column_score(s.grid[0][col]);
+            int before1 = column_score(s.grid[1][col]);
+            for (int roll = 1; roll <= State::sides; ++roll) {
+                auto undo = s.make_move(col, roll);
+                int n0    = s0 - before0 + column_score(s.grid[0][col]);
+                int n1    = s1 - before1 + column_score(s.grid[1][col]);
+                level.nodes += 1;
+                level.removals += undo.removed_row >= 0;
+                level.score_total += static_cast<uint64_t>(n0 + n1);
+                if (s.board_full(mover)) {
+                    count_result(level, n0, n1);
+                } else if (ply + 1 < depth) {
+                    walk(s, ply + 1, depth, n0, n1, levels);
+                }
+                s.unmake_move(undo);
+            }
+        }
+    }
+
+    static int column_score(const uint8_t column[State::rows]) {
+        static constexpr ColumnScores<State::rows, State::sides> table{};
+        int raw = 0;
+        for (int row = 0; row < State::rows; ++row)
+            raw = raw * State::Tables::base + column[row];
+        return table.score[raw];
+    }
+
+    static void count_result(PerftLevel &level, int s0, int s1) {
+        level.terminal += 1;
+        level.p1_wins += s0 > s1;
+        level.ties += s0 == s1;
+    }
+};
@@ -0,0 +1,242 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * GameTask
+ *
+ * Description:
+ *      Coroutine type for game logic. A task starts suspended and runs when a
+ *      Scheduler resumes it. Tasks can `co_await` other tasks (the caller
+ *      continues when the callee finishes) or the awaiters a Scheduler hands
+ *      out for timed waits and player input.
+ *
+ * Usage:
+ *      GameTask turn(Scheduler &sched) {
+ *          co_await sched.sleep_for(std::chrono::milliseconds(50));
+ *          int column = co_await sched.input(0);
+ *      }
+ */
+class GameTask {
+   public:
+    struct promise_type {
+        std::coroutine_handle<> continuation;
+
+        GameTask get_return_object() { return GameTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+
+        // Hands control back to whoever awaited this task, if anyone
+        struct FinalAwaiter {
+            bool await_ready() noexcept { return false; }
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> h) noexcept {
+                std::coroutine_handle<> next = h.promise().continuation;
+                return next ? next : std::noop_coroutine();
+            }
+            void await_resume() noexcept {}
+        };
+        FinalAwaiter final_suspend() noexcept { return {}; }
+
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    GameTask(GameTask &&other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+    GameTask &operator=(GameTask &&other) noexcept {
+        if (this != &other) {
+            if (handle)
+                handle.destroy();
+            handle = std::exchange(other.handle, nullptr);
+        }
+        return *this;
+    }
+    GameTask(const GameTask &)            = delete;
+    GameTask &operator=(const GameTask &) = delete;
+    ~GameTask() {
+        if (handle)
+            handle.destroy();
+    }
+
+    bool done() const { return !handle || handle.done(); }
+    std::coroutine_handle<> get_handle() const { return handle; }
+
+    // Awaiting a task runs it right away and resumes the caller when it ends
+    bool await_ready() const noexcept { return done(); }
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) noexcept {
+        handle.promise().continuation = awaiting;
+        return handle;
+    }
+    void await_resume() const noexcept {}
+
+   private:
+    explicit GameTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * Scheduler
+ *
+ * Description:
+ *      Single-threaded driver for many GameTasks. Tasks that can run sit in a
+ *      ready queue, tasks waiting on a timer sit in a min-heap by wake time,
+ *      and tasks waiting for input are queued per input channel; each
+ *      `provide_input` hands its value to the task that has waited longest.
+ *      When nothing is ready the idle hook (e.g. a non-blocking keyboard
+ *      poll) runs and the thread sleeps until the next timer, so no game
+ *      ever blocks another. Finished tasks are freed in batches as the run
+ *      goes on, so a long run keeps only the frames of games still playing.
+ *
+ * Public Methods:
+ *      - void spawn(GameTask task)                   : Takes ownership and queues the task.
+ *      - SleepAwaiter sleep_for(duration)            : `co_await` to resume after a delay.
+ *      - InputAwaiter input(int channel)             : `co_await` to get the next value for a channel.
+ *      - bool provide_input(int channel, int value)  : Wakes the oldest task waiting on a channel.
+ *      - void set_idle(std::function<void()> hook)   : Called whenever the ready queue is empty.
+ *      - void run()                                  : Runs until no task is ready, sleeping or waiting,
+ *                                                      or only input waits are left and no idle hook can provide it.
+ *
+ * Usage:
+ *      Scheduler sched;
+ *      sched.spawn(game.play(sched));
+ *      sched.run();
+ */
+class Scheduler {
+   public:
+    using Clock = std::chrono::steady_clock;
+
+    struct SleepAwaiter {
+        Scheduler &sched;
+        Clock::time_point until;
+
+        bool await_ready() const { return Clock::now() >= until; }
+        void await_suspend(std::coroutine_handle<> h) { sched.timers.push({until, sched.timer_seq++, h}); }
+        void await_resume() const {}
+    };
+
+    // Lives in the suspended task's frame; provide_input writes the value straight into it
+    struct InputAwaiter {
+        Scheduler &sched;
+        int channel;
+        std::coroutine_handle<> handle = nullptr;
+        int value                      = 0;
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<> h) {
+            if (static_cast<size_t>(channel) >= sched.waiting.size())
+                sched.waiting.resize(channel + 1);
+            handle = h;
+            sched.waiting[channel].push_back(this);
+            ++sched.waiting_count;
+        }
+        int await_resume() const { return value; }
+    };
+
+    void spawn(GameTask task) {
+        ready.push_back(task.get_handle());
+        tasks.push_back(std::move(task));
+    }
+
+    template <typename Rep, typename Period>
+    SleepAwaiter sleep_for(std::chrono::duration<Rep, Period> d) {
+        return SleepAwaiter{*this, Clock::now() + std::chrono::duration_cast<Clock::duration>(d)};
+    }
+
+    InputAwaiter input(int channel) { return InputAwaiter{*this, channel}; }
+
+    // Wakes the task that has waited longest on the channel; false if none is (the value is dropped)
+    bool provide_input(int channel, int value) {
+        if (!waiting_for_input(channel))
+            return false;
+        InputAwaiter *w = waiting[channel].front();
+        waiting[channel].pop_front();
+        w->value = value;
+        ready.push_back(w->handle);
+        --waiting_count;
+        return true;
+    }
+
+    bool waiting_for_input(int channel) const {
+        return static_cast<size_t>(channel) < waiting.size() && !waiting[channel].empty();
+    }
+
+    void set_idle(std::function<void()> hook) { idle = std::move(hook); }
+
+    void run() {
+        while (!ready.empty() || !timers.empty() || waiting_count > 0) {
+            wake_timers();
+            if (ready.empty()) {
+                // with no timer and no idle hook, nothing is left that could provide the input
+                if (timers.empty() && !idle)
+                    break;
+                if (idle)
+                    idle();
+                wake_timers();
+                if (ready.empty()) {
+                    // nothing to do until the next timer or the next idle poll
+                    Clock::time_point until = Clock::now() + idle_interval;
+                    if (!timers.empty() && timers.top().when < until)
+                        until = timers.top().when;
+                    std::this_thread::sleep_until(until);
+                }
+                continue;
+            }
+            // run everything queued so far; tasks woken meanwhile wait for the next pass
+            size_t n = ready.size();
+            for (size_t i = 0; i < n; ++i) {
+                std::coroutine_handle<> h = ready.front();
+                ready.pop_front();
+                h.resume();
+            }
+            if (tasks.size() >= prune_at)
+                prune();
+        }
+        prune();
+    }
+
+    size_t live_tasks() const {
+        size_t n = 0;
+        for (const auto &t : tasks)
+            n += !t.done();
+        return n;
+    }
+
+   private:
+    struct Timer {
+        Clock::time_point when;
+        uint64_t seq;  // keeps equal wake times in spawn order
+        std::coroutine_handle<> handle;
+        bool operator>(const Timer &other) const { return when != other.when ? when > other.when : seq > other.seq; }
+    };
+    std::vector<GameTask> tasks;
+    std::deque<std::coroutine_handle<> > ready;
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer> > timers;
+    std::vector<std::deque<InputAwaiter *> > waiting;  // per channel, in the order the tasks asked
+    std::function<void()> idle;
+    uint64_t timer_seq   = 0;
+    size_t waiting_count = 0;
+    size_t prune_at      = 64;  // task count that triggers the next sweep for finished tasks
+    std::chrono::milliseconds idle_interval{10};
+
+    // Frees finished tasks; the next sweep waits until the list doubles, so each costs O(1) per spawn
+    void prune() {
+        tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [](const GameTask &t) { return t.done(); }), tasks.end());
+        prune_at = std::max<size_t>(64, 2 * tasks.size());
+    }
+
+    void wake_timers() {
+        Clock::time_point now = Clock::now();
+        while (!timers.empty() && timers.top().when <= now) {
+            ready.push_back(timers.top().handle);
+            timers.pop();
+        }
+    }
+};
@@ -0,0 +1,80 @@
+#include "serverClass.hpp"  // epoll game server
+#include <chrono>           // timing
+#include <csignal>          // signal handling
+#include <cstdlib>          // strtoul
+#include <iostream>         // input/output
+#include <string>           // string data structure
+#include <thread>           // sleep_for
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Game Server
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Headless server that hosts many Knucklebones games at once over a
+*        Unix-domain socket. Prints the moves handled per second until it is
+*        stopped with Ctrl-C. Given a snapshot file it saves every live game
+*        there periodically and on exit, and reloads them at startup, so a
+*        restarted server picks up where it left off.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o server server.cpp boardVariants.cpp`
+*        - Run with `./server [socket_path] [loops] [games_per_loop] [snapshot_file] [snapshot_secs]`
+*        - Drive it with `./loadClient` (see loadClient.cpp)
+*        - Clients reclaim restored games by sending RESUME with the old game id; games
+*          nobody resumes within five minutes are dropped
+*
+*  Files:             server.cpp        : driver program for the server
+*                     serverClass.hpp   : wire protocol, game pool and event loops
+*                     boardState.hpp    : compact game state and rules
+*****************************************************************************/
+
+static volatile std::sig_atomic_t stop_requested = 0;
+
+void on_signal(int) { stop_requested = 1; }
+
+int main(int argc, char **argv) {
+    std::string path  = argc > 1 ? argv[1] : "/tmp/knucklebones.sock";
+    unsigned loops    = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : std::thread::hardware_concurrency();
+    uint32_t per_loop  = argc > 3 ? static_cast<uint32_t>(std::strtoul(argv[3], nullptr, 10)) : 65536;
+    std::string snap   = argc > 4 ? argv[4] : "";
+    int snap_every     = argc > 5 ? static_cast<int>(std::strtoul(argv[5], nullptr, 10)) : 5;
+
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    GameServer server(path, loops, per_loop);
+    if (!snap.empty()) {
+        auto start = std::chrono::steady_clock::now();
+        if (server.restore(snap)) {
+            double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            std::cout << "restored " << server.unclaimed() << " games from " << snap << " in " << ms << " ms" << std::endl;
+        }
+    }
+    if (!server.start()) {
+        std::cerr << "Unable to listen on " << path << std::endl;
+        return 1;
+    }
+    std::cout << "listening on " << path << " with " << (loops ? loops : 1) << " loop(s)" << std::endl;
+
+    uint64_t last = 0;
+    for (int tick = 1; !stop_requested; ++tick) {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        uint64_t now = server.moves();
+        std::cout << "moves/s: " << (now - last) << std::endl;
+        last = now;
+        if (!snap.empty() && snap_every > 0 && tick % snap_every == 0) {
+            if (server.snapshot(snap))
+                std::cout << "snapshot saved, loops paused " << server.last_snapshot_pause_ms() << " ms" << std::endl;
+        }
+    }
+    if (!snap.empty() && server.snapshot(snap))
+        std::cout << "final snapshot saved to " << snap << std::endl;
+    server.stop();
+    return 0;
+}
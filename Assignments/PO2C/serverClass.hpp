@@ -0,0 +1,736 @@
+#pragma once
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "boardState.hpp"
+
+/**
+ * Wire protocol
+ *
+ * Description:
+ *      Fixed size binary messages, host byte order (the server is local only).
+ *      A client sends MoveRequest records and gets exactly one MoveReply back
+ *      for each, in order, so requests for many games can be pipelined on one
+ *      connection. The server rolls every die; the client only picks columns.
+ *
+ *      NEW_GAME : starts a game, the reply carries its id and the first roll.
+ *      MOVE     : plays the pending roll of `game_id` into `column`.
+ *      QUIT     : abandons `game_id` and returns its slot to the pool.
+ *      RESUME   : claims a game restored from a snapshot by the id it had before
+ *                 the restart. The game moves to the connection's loop, so the
+ *                 reply carries its new id, to be used from then on, with its
+ *                 current roll and scores as for any other request.
+ */
+enum MoveOp : uint8_t { OP_NEW_GAME = 1, OP_MOVE = 2, OP_QUIT = 3, OP_RESUME = 4 };
+
+enum MoveStatus : uint8_t { ST_OK = 0, ST_GAME_OVER = 1, ST_ILLEGAL = 2, ST_NO_GAME = 3, ST_FULL = 4 };
+
+struct MoveRequest {
+    uint8_t op;
+    uint8_t column;
+    uint16_t reserved;
+    uint32_t game_id;
+};
+
+struct MoveReply {
+    uint8_t status;
+    uint8_t roll;   // die the side to move must place next
+    uint8_t turn;   // side to move
+    uint8_t legal;  // bit per column the side to move may use
+    uint32_t game_id;
+    uint16_t score[2];
+};
+
+static_assert(sizeof(MoveRequest) == 8, "MoveRequest must stay 8 bytes");
+static_assert(sizeof(MoveReply) == 12, "MoveReply must stay 12 bytes");
+static_assert(GameState::cols <= 8, "MoveReply::legal has one bit per column");
+
+/**
+ * GamePool
+ *
+ * Description:
+ *      Arena of game slots owned by one event loop. Slots live in a single
+ *      preallocated vector and are recycled through a free list, so starting
+ *      and finishing games never touches the heap. A game id is the loop
+ *      number in the top 8 bits, then the slot's generation, then the slot
+ *      number in the low `index_bits` (just enough bits for the capacity, at
+ *      most 2^20 slots). The generation goes up each time the slot is freed,
+ *      so the id of a finished game no longer finds whoever reuses its slot;
+ *      with 65536 slots it has 8 bits and wraps after 256 reuses.
+ *
+ * Public Methods:
+ *      - GamePool(int loop, uint32_t capacity)
+ *      - Slot* create(int owner_fd, uint64_t seed) : New game, nullptr when full.
+ *      - Slot* find(uint32_t game_id, int owner_fd) : Live game owned by the connection.
+ *      - void release(Slot* slot)
+ *      - void release_owner(int owner_fd)          : Drops every game of a closed connection.
+ *      - void copy_slots(std::vector<Slot>& out) const : Raw copy of every slot, for snapshots.
+ *      - Slot* adopt(int owner_fd, const SavedGame& g) : New slot holding a restored game.
+ *      - void retire(const std::vector<SavedGame>& games) : Keeps new ids clear of restored ones.
+ *      - static bool valid(const SavedGame& g)      : False for a record no game could be in.
+ */
+class GamePool {
+   public:
+    // Ordered to pack into 40 bytes; snapshots copy the whole arena
+    struct Slot {
+        GameState state;
+        uint8_t roll       = 0;   // pending die for the side to move
+        int owner_fd       = -1;  // connection that created the game, -1 when free
+        uint64_t rng       = 0;   // xorshift state, advanced once per roll
+        uint32_t id        = 0;
+        uint32_t next_free = 0;
+    };
+
+    // One game in a snapshot image
+    struct SavedGame {
+        uint32_t id;
+        uint8_t roll;
+        uint8_t reserved[3];
+        uint64_t rng;
+        GameState state;
+    };
+
+    static constexpr uint32_t max_capacity = 1u << 20;  // leaves the generation at least 4 bits
+
+    GamePool(int loop, uint32_t capacity) : loop(loop), slots(std::min(capacity, max_capacity)) {
+        while ((1u << index_bits) < slots.size())
+            ++index_bits;
+        for (uint32_t i = 0; i < slots.size(); ++i) {
+            slots[i].id        = (static_cast<uint32_t>(loop) << 24) | i;
+            slots[i].next_free = i + 1;
+        }
+        free_head = 0;
+    }
+
+    uint32_t index_of(uint32_t game_id) const { return game_id & ((1u << index_bits) - 1); }
+
+    Slot *create(int owner_fd, uint64_t seed) {
+        if (free_head >= slots.size())
+            return nullptr;
+        Slot *slot     = &slots[free_head];
+        free_head      = slot->next_free;
+        slot->state    = GameState();
+        slot->rng      = seed | 1;
+        slot->owner_fd = owner_fd;
+        slot->roll     = roll(*slot);
+        ++live;
+        return slot;
+    }
+
+    Slot *find(uint32_t game_id, int owner_fd) {
+        uint32_t index = index_of(game_id);
+        if (index >= slots.size())
+            return nullptr;
+        Slot *slot = &slots[index];
+        return slot->id == game_id && slot->owner_fd == owner_fd ? slot : nullptr;
+    }
+
+    void release(Slot *slot) {
+        slot->id        = next_generation(slot->id);
+        slot->owner_fd  = -1;
+        slot->next_free = free_head;
+        free_head       = index_of(slot->id);
+        --live;
+    }
+
+    void release_owner(int owner_fd) {
+        for (auto &slot : slots) {
+            if (slot.owner_fd == owner_fd)
+                release(&slot);
+        }
+    }
+
+    static uint8_t roll(Slot &slot) {
+        slot.rng ^= slot.rng << 13;
+        slot.rng ^= slot.rng >> 7;
+        slot.rng ^= slot.rng << 17;
+        return static_cast<uint8_t>(slot.rng % GameState::sides + 1);
+    }
+
+    size_t live_games() const { return live; }
+
+    // Slots are trivially copyable, so this is one memcpy into a buffer of the same size
+    void copy_slots(std::vector<Slot> &out) const { std::copy(slots.begin(), slots.end(), out.begin()); }
+
+    Slot *adopt(int owner_fd, const SavedGame &g) {
+        Slot *slot = create(owner_fd, g.rng);
+        if (slot) {
+            slot->state = g.state;
+            slot->rng   = g.rng;
+            slot->roll  = g.roll;
+        }
+        return slot;
+    }
+
+    /**
+     * Moves the slot of each restored game that came from this loop one
+     * generation past the game's id. Restored games wait outside the pools
+     * until they are resumed, so without this a new game could be handed
+     * the id a client is about to resume with.
+     */
+    void retire(const std::vector<SavedGame> &games) {
+        for (const auto &g : games) {
+            uint32_t index = index_of(g.id);
+            if ((g.id >> 24) == static_cast<uint32_t>(loop) && index < slots.size())
+                slots[index].id = next_generation(g.id);
+        }
+    }
+
+    // A snapshot record is used to index the scoring tables, so a bad one must not get that far
+    static bool valid(const SavedGame &g) {
+        if (g.roll < 1 || g.roll > GameState::sides || g.state.turn > 1 || g.state.is_over())
+            return false;
+        for (const auto &board : g.state.grid)
+            for (const auto &column : board)
+                for (uint8_t cell : column)
+                    if (cell > GameState::sides)
+                        return false;
+        return true;
+    }
+
+   private:
+    int loop;
+    std::vector<Slot> slots;
+    int index_bits = 0;
+
+    // Same slot, next generation: adding a multiple of the index range leaves the index alone
+    uint32_t next_generation(uint32_t id) const {
+        uint32_t low = (id & 0xFFFFFF) + (1u << index_bits);
+        return (id & 0xFF000000) | (low & 0xFFFFFF);
+    }
+    uint32_t free_head;
+    size_t live = 0;
+};
+
+/**
+ * GameServer
+ *
+ * Description:
+ *      Headless server that hosts many Knucklebones games in one process over
+ *      a Unix-domain socket. Each worker thread runs its own epoll loop and
+ *      game pool; they share the listening socket through EPOLLEXCLUSIVE so a
+ *      new connection wakes a single loop, which then owns it and its games.
+ *      Every readable connection is drained, all complete requests are
+ *      handled, and the replies go out with a single write. A client that
+ *      sends without reading its replies stops being read once out_cap bytes
+ *      of them are waiting, until it catches up.
+ *
+ * Public Methods:
+ *      - GameServer(const std::string& path, unsigned loops = 1, uint32_t games_per_loop = 65536)
+ *      - bool start()  : Binds the socket and launches the loops.
+ *      - void stop()   : Asks the loops to exit and joins them.
+ *      - uint64_t moves() const : Moves handled so far.
+ *      - bool snapshot(const std::string& file) : Saves every live game while the loops keep running.
+ *      - bool restore(const std::string& file)  : Loads a snapshot; call before start().
+ *      - void set_orphan_ttl(std::chrono::seconds ttl) : How long restored games wait to be resumed.
+ *      - size_t unclaimed() const               : Restored games not resumed (or expired) yet.
+ *      - double last_snapshot_pause_ms() const  : Longest loop pause of the last snapshot.
+ *      - static constexpr size_t out_cap         : Replies buffered per connection before it stops being read.
+ *
+ *      Snapshots are double buffered. Each loop owns a shadow copy of its slot
+ *      arena; when a snapshot is requested the loop copies its slots into the
+ *      shadow between two event batches (one memcpy, ~0.5 ms for 100k games)
+ *      and carries on. The caller's thread then picks out the live games and
+ *      writes the image, renaming it over the old one so a crash mid-write
+ *      leaves the previous snapshot intact. Each loop copies at its next
+ *      wakeup, at most 100 ms later; games never span loops, so every pool is
+ *      consistent on its own.
+ *
+ *      Image layout: header {magic "KBSNAP2", loops, games_per_loop}, then per
+ *      loop {loop, game count, seed} followed by that many SavedGame records.
+ *      Every record is checked on load and one bad cell rejects the image.
+ *
+ *      Restored games wait in a table shared by the loops, keyed by the id
+ *      they had, because a reconnecting client may land on any loop. RESUME
+ *      takes a game out of the table into the claiming loop's pool, under a
+ *      new id in that loop. Games nobody resumes within the orphan ttl (five
+ *      minutes unless set) are dropped. Unclaimed games are written into
+ *      each snapshot as they were restored, so a second crash loses nothing.
+ *      So is a game claimed after its loop copied its shadow for a snapshot,
+ *      which that shadow misses: the image then has it as restored, under
+ *      its old id, rather than not at all.
+ *
+ * Usage:
+ *      GameServer server("/tmp/knucklebones.sock", 4);
+ *      server.restore("games.snap");  // optional, after a crash
+ *      server.start();
+ *      server.snapshot("games.snap");  // e.g. every few seconds
+ *      ...
+ *      server.stop();
+ */
+class GameServer {
+   public:
+    GameServer(const std::string &path, unsigned loops = 1, uint32_t games_per_loop = 65536)
+        : path(path), loop_count(loops ? loops : 1),
+          games_per_loop(std::min(games_per_loop, GamePool::max_capacity)) {}
+
+    ~GameServer() { stop(); }
+
+    // A client that pipelines requests but does not read its replies is not read from
+    // while this much is waiting for it, so a connection's replies stay bounded. A client
+    // that writes everything before reading should keep fewer requests than
+    // out_cap / sizeof(MoveReply) outstanding, or both ends can block.
+    static constexpr size_t out_cap = 256 * 1024;
+
+    bool start() {
+        listen_fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK, 0);
+        if (listen_fd < 0)
+            return false;
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(path.c_str());
+        if (bind(listen_fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 || listen(listen_fd, SOMAXCONN) < 0) {
+            close(listen_fd);
+            listen_fd = -1;
+            return false;
+        }
+        running = true;
+        shadows.clear();
+        shadows.resize(loop_count);
+        for (auto &sh : shadows)
+            sh.slots.resize(games_per_loop);
+        restored.resize(loop_count);
+        orphan_deadline = std::chrono::steady_clock::now() + orphan_ttl;
+        for (unsigned i = 0; i < loop_count; ++i)
+            workers.emplace_back(&GameServer::run_loop, this, static_cast<int>(i));
+        return true;
+    }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(shadow_mutex);
+            running = false;
+        }
+        shadow_ready.notify_all();  // a snapshot() waiting on the loops gives up
+        for (auto &t : workers)
+            t.join();
+        workers.clear();
+        if (listen_fd >= 0) {
+            close(listen_fd);
+            unlink(path.c_str());
+            listen_fd = -1;
+        }
+    }
+
+    uint64_t moves() const { return move_count.load(std::memory_order_relaxed); }
+
+    bool snapshot(const std::string &file) {
+        std::lock_guard<std::mutex> one_at_a_time(snapshot_mutex);
+        if (!running)
+            return false;
+        uint64_t gen = snapshot_request.fetch_add(1) + 1;
+        {
+            std::unique_lock<std::mutex> lock(shadow_mutex);
+            shadow_ready.wait(lock, [&]() {
+                if (!running)
+                    return true;
+                for (const auto &sh : shadows) {
+                    if (sh.generation != gen)
+                        return false;
+                }
+                return true;
+            });
+            if (!running)
+                return false;
+        }
+
+        // the loops are running again; only the shadows are read from here on
+        std::vector<std::vector<GamePool::SavedGame> > waiting(loop_count);
+        {
+            std::lock_guard<std::mutex> lock(orphan_mutex);
+            for (const auto &o : orphans) {
+                if ((o.first >> 24) < loop_count)
+                    waiting[o.first >> 24].push_back(o.second);
+            }
+            // claimed after the claiming loop copied its shadow for this snapshot: not in any shadow
+            for (const auto &c : claimed) {
+                if (c.first == gen && (c.second.id >> 24) < loop_count)
+                    waiting[c.second.id >> 24].push_back(c.second);
+            }
+            claimed.erase(std::remove_if(claimed.begin(), claimed.end(), [&](const auto &c) { return c.first < gen; }),
+                          claimed.end());
+        }
+        std::string tmp = file + ".tmp";
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out.is_open())
+            return false;
+        SnapshotHeader h;
+        std::memcpy(h.magic, snapshot_magic, sizeof(h.magic));
+        h.loops          = loop_count;
+        h.games_per_loop = games_per_loop;
+        out.write(reinterpret_cast<const char *>(&h), sizeof(h));
+        std::vector<GamePool::SavedGame> games;
+        double pause_ms = 0.0;
+        for (uint32_t loop = 0; loop < loop_count; ++loop) {
+            const Shadow &sh = shadows[loop];
+            pause_ms         = std::max(pause_ms, sh.pause_ms);
+            games.clear();
+            for (uint32_t i = 0; i < games_per_loop; ++i) {
+                const GamePool::Slot &slot = sh.slots[i];
+                if (slot.owner_fd == -1)
+                    continue;
+                GamePool::SavedGame g{};
+                g.id    = slot.id;
+                g.roll  = slot.roll;
+                g.rng   = slot.rng;
+                g.state = slot.state;
+                games.push_back(g);
+            }
+            games.insert(games.end(), waiting[loop].begin(), waiting[loop].end());
+            LoopHeader lh{loop, static_cast<uint32_t>(games.size()), sh.seed};
+            out.write(reinterpret_cast<const char *>(&lh), sizeof(lh));
+            out.write(reinterpret_cast<const char *>(games.data()),
+                      static_cast<std::streamsize>(games.size() * sizeof(GamePool::SavedGame)));
+        }
+        out.close();
+        last_pause_ms = pause_ms;
+        return out.good() && std::rename(tmp.c_str(), file.c_str()) == 0;
+    }
+
+    bool restore(const std::string &file) {
+        if (running)
+            return false;
+        std::ifstream in(file, std::ios::binary);
+        if (!in.is_open())
+            return false;
+        SnapshotHeader h;
+        if (!in.read(reinterpret_cast<char *>(&h), sizeof(h)) ||
+            std::memcmp(h.magic, snapshot_magic, sizeof(h.magic)) != 0 || h.loops != loop_count ||
+            h.games_per_loop != games_per_loop)
+            return false;
+        std::vector<Restored> loaded(loop_count);
+        std::unordered_map<uint32_t, GamePool::SavedGame> waiting;
+        for (uint32_t loop = 0; loop < loop_count; ++loop) {
+            LoopHeader lh;
+            if (!in.read(reinterpret_cast<char *>(&lh), sizeof(lh)) || lh.loop != loop || lh.count > games_per_loop)
+                return false;
+            loaded[loop].seed = lh.seed;
+            loaded[loop].games.resize(lh.count);
+            if (!in.read(reinterpret_cast<char *>(loaded[loop].games.data()),
+                         static_cast<std::streamsize>(lh.count * sizeof(GamePool::SavedGame))))
+                return false;
+            for (const auto &g : loaded[loop].games) {
+                if ((g.id >> 24) != loop || !GamePool::valid(g) || !waiting.emplace(g.id, g).second)
+                    return false;
+            }
+        }
+        restored.swap(loaded);
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        orphans.swap(waiting);
+        claimed.clear();
+        orphan_count = orphans.size();
+        return true;
+    }
+
+    void set_orphan_ttl(std::chrono::seconds ttl) { orphan_ttl = ttl; }
+
+    size_t unclaimed() const { return orphan_count.load(std::memory_order_relaxed); }
+
+    double last_snapshot_pause_ms() const { return last_pause_ms; }
+
+   private:
+    struct Connection {
+        int fd = -1;
+        std::vector<char> in;   // bytes of a partial request carried to the next read
+        std::vector<char> out;  // replies not yet accepted by the socket
+        uint32_t events = 0;    // what the connection is registered for
+    };
+
+    std::string path;
+    unsigned loop_count;
+    uint32_t games_per_loop;
+    int listen_fd = -1;
+    std::atomic<bool> running{false};
+    std::atomic<uint64_t> move_count{0};
+    std::vector<std::thread> workers;
+
+    struct SnapshotHeader {
+        char magic[8];
+        uint32_t loops;
+        uint32_t games_per_loop;
+    };
+    struct LoopHeader {
+        uint32_t loop;
+        uint32_t count;
+        uint64_t seed;
+    };
+    static constexpr char snapshot_magic[8] = {'K', 'B', 'S', 'N', 'A', 'P', '2', '\0'};
+
+    // A loop's copy of its pool, written only by that loop when asked
+    struct Shadow {
+        std::vector<GamePool::Slot> slots;
+        uint64_t seed       = 0;
+        uint64_t generation = 0;
+        double pause_ms     = 0.0;
+    };
+    struct Restored {
+        uint64_t seed = 0;
+        std::vector<GamePool::SavedGame> games;
+    };
+    std::vector<Shadow> shadows;
+    std::vector<Restored> restored;  // filled by restore(), used once by each loop at start
+
+    // Restored games no connection has resumed yet, by the id they were saved with
+    std::mutex orphan_mutex;
+    std::unordered_map<uint32_t, GamePool::SavedGame> orphans;
+    // Games resumed since then, with the snapshot generation their loop had copied when it claimed them
+    std::vector<std::pair<uint64_t, GamePool::SavedGame> > claimed;
+    std::atomic<size_t> orphan_count{0};
+    std::chrono::seconds orphan_ttl{300};
+    std::chrono::steady_clock::time_point orphan_deadline;
+
+    std::atomic<uint64_t> snapshot_request{0};
+    std::mutex snapshot_mutex;  // one snapshot() at a time
+    std::mutex shadow_mutex;
+    std::condition_variable shadow_ready;
+    double last_pause_ms = 0.0;
+
+    void run_loop(int loop) {
+        int ep = epoll_create1(0);
+        epoll_event ev;
+        ev.events  = EPOLLIN | EPOLLEXCLUSIVE;
+        ev.data.fd = listen_fd;
+        epoll_ctl(ep, EPOLL_CTL_ADD, listen_fd, &ev);
+
+        GamePool pool(loop, games_per_loop);
+        std::vector<Connection> conns;  // indexed by fd
+        uint64_t seed = 0x9E3779B97F4A7C15ull * static_cast<uint64_t>(loop + 1);
+        if (restored[loop].seed) {
+            pool.retire(restored[loop].games);
+            seed = restored[loop].seed;
+            restored[loop] = Restored();
+        }
+        uint64_t snapshot_taken = 0;  // so a snapshot asked for before this loop started is still copied
+        uint64_t local_moves = 0;
+        std::vector<char> buffer(64 * 1024);
+        epoll_event events[256];
+
+        while (running) {
+            int n = epoll_wait(ep, events, 256, 100);
+            for (int i = 0; i < n; ++i) {
+                int fd = events[i].data.fd;
+                if (fd == listen_fd) {
+                    accept_all(ep, conns);
+                    continue;
+                }
+                Connection &c = conns[fd];
+                bool alive    = true;
+                if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+                    alive = read_requests(c, pool, buffer, seed, local_moves, snapshot_taken);
+                if (alive && (!c.out.empty() || (c.events & EPOLLOUT)))
+                    alive = flush(ep, c);
+                if (!alive) {
+                    pool.release_owner(fd);
+                    epoll_ctl(ep, EPOLL_CTL_DEL, fd, nullptr);
+                    close(fd);
+                    c = Connection();
+                }
+            }
+            move_count.fetch_add(local_moves, std::memory_order_relaxed);
+            local_moves = 0;
+            if (loop == 0)
+                expire_orphans();
+
+            uint64_t wanted = snapshot_request.load(std::memory_order_acquire);
+            if (wanted != snapshot_taken) {
+                Shadow &sh = shadows[loop];
+                auto start = std::chrono::steady_clock::now();
+                pool.copy_slots(sh.slots);
+                sh.seed     = seed;
+                sh.pause_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                snapshot_taken = wanted;
+                {
+                    std::lock_guard<std::mutex> lock(shadow_mutex);
+                    sh.generation = wanted;
+                }
+                shadow_ready.notify_all();
+            }
+        }
+        for (auto &c : conns) {
+            if (c.fd >= 0)
+                close(c.fd);
+        }
+        close(ep);
+    }
+
+    void accept_all(int ep, std::vector<Connection> &conns) {
+        while (true) {
+            int fd = accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK);
+            if (fd < 0)
+                return;
+            if (static_cast<size_t>(fd) >= conns.size())
+                conns.resize(fd + 1);
+            conns[fd].fd     = fd;
+            conns[fd].events = EPOLLIN | EPOLLRDHUP;
+            epoll_event ev;
+            ev.events  = conns[fd].events;
+            ev.data.fd = fd;
+            epoll_ctl(ep, EPOLL_CTL_ADD, fd, &ev);
+        }
+    }
+
+    // Returns false when the peer closed the connection; stops early once `out` reaches out_cap
+    bool read_requests(Connection &c, GamePool &pool, std::vector<char> &buffer, uint64_t &seed, uint64_t &moves,
+                       uint64_t taken) {
+        while (c.out.size() < out_cap) {
+            size_t carried = c.in.size();
+            std::memcpy(buffer.data(), c.in.data(), carried);
+            ssize_t got = read(c.fd, buffer.data() + carried, buffer.size() - carried);
+            if (got == 0)
+                return false;
+            if (got < 0)
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+
+            size_t total = carried + static_cast<size_t>(got);
+            size_t whole = total - total % sizeof(MoveRequest);
+            size_t base  = c.out.size();
+            c.out.resize(base + whole / sizeof(MoveRequest) * sizeof(MoveReply));
+            for (size_t off = 0; off < whole; off += sizeof(MoveRequest)) {
+                MoveRequest req;
+                MoveReply rep;
+                std::memcpy(&req, buffer.data() + off, sizeof(req));
+                handle(req, rep, c.fd, pool, seed, moves, taken);
+                std::memcpy(c.out.data() + base, &rep, sizeof(rep));
+                base += sizeof(rep);
+            }
+            c.in.assign(buffer.data() + whole, buffer.data() + total);
+        }
+        return true;
+    }
+
+    // `taken` is the last snapshot generation this loop copied its shadow for
+    void handle(const MoveRequest &req, MoveReply &rep, int fd, GamePool &pool, uint64_t &seed, uint64_t &moves,
+                uint64_t taken) {
+        std::memset(&rep, 0, sizeof(rep));
+        rep.game_id = req.game_id;
+        GamePool::Slot *slot = nullptr;
+
+        if (req.op == OP_NEW_GAME) {
+            seed += 0x9E3779B97F4A7C15ull;
+            slot = pool.create(fd, seed);
+            if (!slot) {
+                rep.status = ST_FULL;
+                return;
+            }
+        } else {
+            if (req.op == OP_RESUME) {
+                slot = claim(req.game_id, fd, pool, taken, rep);
+                if (!slot)
+                    return;
+            } else {
+                slot = pool.find(req.game_id, fd);
+                if (!slot) {
+                    rep.status = ST_NO_GAME;
+                    return;
+                }
+            }
+            if (req.op == OP_QUIT) {
+                pool.release(slot);
+                return;
+            }
+            // RESUME plays nothing, its reply just reports where the game stands
+            if (req.op == OP_MOVE && req.column < GameState::cols && !slot->state.column_full(slot->state.turn, req.column)) {
+                slot->state.place(req.column, slot->roll);
+                slot->roll = GamePool::roll(*slot);
+                ++moves;
+            } else if (req.op != OP_RESUME) {
+                rep.status = ST_ILLEGAL;
+            }
+        }
+
+        const GameState &s = slot->state;
+        rep.game_id        = slot->id;
+        rep.roll           = slot->roll;
+        rep.turn           = s.turn;
+        rep.score[0]       = static_cast<uint16_t>(s.score(0));
+        rep.score[1]       = static_cast<uint16_t>(s.score(1));
+        for (int col = 0; col < GameState::cols; ++col)
+            rep.legal |= s.column_full(s.turn, col) ? 0 : (1 << col);
+        if (s.is_over()) {
+            rep.status = ST_GAME_OVER;
+            rep.legal  = 0;
+            pool.release(slot);
+        }
+    }
+
+    // Moves a restored game into this loop's pool; sets the reply's status when it cannot
+    GamePool::Slot *claim(uint32_t game_id, int fd, GamePool &pool, uint64_t taken, MoveReply &rep) {
+        rep.status = ST_NO_GAME;
+        if (orphan_count.load(std::memory_order_relaxed) == 0)
+            return nullptr;
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        auto it = orphans.find(game_id);
+        if (it == orphans.end() || std::chrono::steady_clock::now() >= orphan_deadline)
+            return nullptr;
+        GamePool::Slot *slot = pool.adopt(fd, it->second);
+        if (!slot) {
+            rep.status = ST_FULL;  // still claimable, from a loop with room
+            return nullptr;
+        }
+        rep.status = ST_OK;
+        claimed.emplace_back(taken, it->second);
+        orphans.erase(it);
+        orphan_count.fetch_sub(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    // Drops the restored games nobody resumed in time
+    void expire_orphans() {
+        if (orphan_count.load(std::memory_order_relaxed) == 0 || std::chrono::steady_clock::now() < orphan_deadline)
+            return;
+        std::lock_guard<std::mutex> lock(orphan_mutex);
+        orphans.clear();
+        orphan_count = 0;
+    }
+
+    /**
+     * Writes pending replies; waits for EPOLLOUT only if the socket is full.
+     * While `out` is at out_cap the connection waits for EPOLLOUT alone, so
+     * nothing more is read from it until the client takes its replies.
+     */
+    bool flush(int ep, Connection &c) {
+        size_t sent = 0;
+        while (sent < c.out.size()) {
+            ssize_t n = write(c.fd, c.out.data() + sent, c.out.size() - sent);
+            if (n < 0) {
+                if (errno != EAGAIN && errno != EWOULDBLOCK)
+                    return false;
+                break;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        c.out.erase(c.out.begin(), c.out.begin() + sent);
+        uint32_t events = c.out.size() >= out_cap ? uint32_t(EPOLLOUT)
+                                                  : EPOLLIN | EPOLLRDHUP | (c.out.empty() ? 0u : uint32_t(EPOLLOUT));
+        if (c.events != events) {
+            c.events = events;
+            epoll_event ev;
+            ev.events  = events;
+            ev.data.fd = c.fd;
+            epoll_ctl(ep, EPOLL_CTL_MOD, c.fd, &ev);
+        }
+        return true;
+    }
+};
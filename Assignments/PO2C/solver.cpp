@@ -0,0 +1,89 @@
+#include "boardState.hpp"   // compact game state
+#include "solverClass.hpp"  // retrograde solver and solution table
+#include <chrono>           // timing
+#include <cstdlib>          // strtoul
+#include <iostream>         // input/output
+#include <string>           // string data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Solver
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Offline solver for Knucklebones. Starting from a position it finds
+*        every reachable position, computes the exact value of each one with
+*        retrograde analysis and writes the solution table to a file that the
+*        game and AI players can load and query.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o solver solver.cpp boardVariants.cpp`
+*        - Run with `./solver <out_file> [p1_board] [p2_board] [threads] [max_states]`
+*        - Boards are 9 characters, column by column (3 rows each), '.' for empty,
+*          e.g. `./solver late.bin 66.345.12 1.3.55616` solves from that position.
+*
+*  Files:             solver.cpp        : driver program for the solver
+*                     boardState.hpp    : compact game state and rules
+*                     solverClass.hpp   : solver and solution table
+*****************************************************************************/
+
+/**
+ * usage
+ *
+ * Description:
+ *      Prints how to run the solver and returns the exit code for bad arguments.
+ */
+int usage(const char *name) {
+    std::cerr << "usage: " << name << " <out_file> [p1_board] [p2_board] [threads] [max_states]" << std::endl;
+    std::cerr << "boards are " << GameState::rows * GameState::cols << " characters of '.' or 1-" << GameState::sides
+              << ", column by column" << std::endl;
+    return 1;
+}
+
+/**
+ * parse_count
+ *
+ * Description:
+ *      Reads a whole decimal number, so a typo is an error rather than 0.
+ */
+bool parse_count(const char *text, size_t &value) {
+    char *end;
+    value = std::strtoul(text, &end, 10);
+    return end != text && *end == '\0';
+}
+
+int main(int argc, char **argv) {
+    // the solve can take minutes, so anything unexpected only prints the usage
+    if (argc < 2 || argc > 6 || argv[1][0] == '-')
+        return usage(argv[0]);
+
+    GameState root;
+    size_t threads = 0, max_states = 50000000;
+    if ((argc > 2 && !root.parse_board(0, argv[2])) || (argc > 3 && !root.parse_board(1, argv[3])) ||
+        (argc > 4 && !parse_count(argv[4], threads)) || (argc > 5 && !parse_count(argv[5], max_states)))
+        return usage(argv[0]);
+
+    Solver solver(static_cast<unsigned>(threads), max_states);
+    SolutionTable table;
+    auto start = std::chrono::steady_clock::now();
+    if (!solver.solve(root, table)) {
+        std::cerr << "more than " << max_states << " reachable states, raise max_states or pick a later position" << std::endl;
+        return 1;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << root.to_string();
+    std::cout << "states: " << solver.states() << " solved in " << secs << "s" << std::endl;
+    std::cout << "value for player " << (root.turn + 1) << ": " << table.value(root) << std::endl;
+    for (int roll = 1; roll <= GameState::sides; ++roll)
+        std::cout << "roll " << roll << " -> column " << table.best_move(root, roll) << std::endl;
+
+    if (!table.save(argv[1])) {
+        std::cerr << "Unable to open file: " << argv[1] << std::endl;
+        return 1;
+    }
+    return 0;
+}
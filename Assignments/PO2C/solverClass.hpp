@@ -0,0 +1,336 @@
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "boardState.hpp"
+#include "strategyClass.hpp"
+
+/**
+ * SolutionTable
+ *
+ * Description:
+ *      Result of the retrograde solver. Maps GameState::canonical().key to the exact
+ *      value of the position for the side to move, where a win counts 1 and a
+ *      tie counts 0.5 (so the value is P(win) + P(tie) / 2). Lookups are a
+ *      single hash probe, and the best column for a roll is three probes.
+ *
+ * Public Methods:
+ *      - bool   contains(const GameState &s) const         : True if the state was solved.
+ *      - double value(const GameState &s) const            : Value for the side to move (-1 if unknown).
+ *      - double move_value(const GameState &s, int column, int roll) const
+ *      - int    best_move(const GameState &s, int roll) const : Optimal column, -1 if none/unknown.
+ *      - bool   save(const std::string &path) const / load(const std::string &path)
+ *
+ *      File layout (native endian): magic "KBSOLV1", entry count, then
+ *      16-byte { key, value } entries sorted by key. `load` accepts only a
+ *      file of exactly that length.
+ *
+ * Usage:
+ *      SolutionTable table;
+ *      table.load("solution.bin");
+ *      int column = table.best_move(state, roll);
+ */
+class SolutionTable {
+   public:
+    bool contains(const GameState &s) const { return values.count(s.canonical().key) > 0; }
+
+    double value(const GameState &s) const {
+        auto it = values.find(s.canonical().key);
+        return it == values.end() ? -1.0 : it->second;
+    }
+
+    // Value for the mover after playing `roll` into `column`, -1 if illegal or unknown
+    double move_value(const GameState &s, int column, int roll) const {
+        if (s.column_full(s.turn, column))
+            return -1.0;
+        GameState child = s;
+        child.place(column, roll);
+        if (child.is_over())
+            return terminal_value(child, s.turn);
+        double v = value(child);
+        return v < 0 ? -1.0 : 1.0 - v;
+    }
+
+    int best_move(const GameState &s, int roll) const {
+        int best_col     = -1;
+        double best_val  = -1.0;
+        for (int col = 0; col < GameState::cols; ++col) {
+            double v = move_value(s, col, roll);
+            if (v > best_val) {
+                best_val = v;
+                best_col = col;
+            }
+        }
+        return best_col;
+    }
+
+    void set(uint64_t key, double v) { values[key] = v; }
+    void reserve(size_t n) { values.reserve(n); }
+    size_t size() const { return values.size(); }
+
+    // Outcome of a finished game for `player`: 1 win, 0.5 tie, 0 loss
+    static double terminal_value(const GameState &s, int player) {
+        int mine   = s.score(player);
+        int theirs = s.score(player ^ 1);
+        return mine > theirs ? 1.0 : (mine == theirs ? 0.5 : 0.0);
+    }
+
+    // Binary file: magic, entry count, then (key, value) pairs sorted by key
+    bool save(const std::string &path) const {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        std::vector<Entry> entries;
+        entries.reserve(values.size());
+        for (const auto &e : values)
+            entries.push_back(Entry{e.first, e.second});
+        std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) { return a.key < b.key; });
+        uint64_t count = entries.size();
+        file.write(magic, sizeof(magic));
+        file.write(reinterpret_cast<const char *>(&count), sizeof(count));
+        file.write(reinterpret_cast<const char *>(entries.data()), static_cast<std::streamsize>(count * sizeof(Entry)));
+        return file.good();
+    }
+
+    // Fails, leaving the table empty, unless the file is a whole table: right magic, exactly `count` entries
+    bool load(const std::string &path) {
+        values.clear();
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file.is_open())
+            return false;
+        uint64_t size = static_cast<uint64_t>(file.tellg());
+        file.seekg(0);
+        char found[sizeof(magic)];
+        uint64_t count = 0;
+        file.read(found, sizeof(found));
+        file.read(reinterpret_cast<char *>(&count), sizeof(count));
+        if (!file || std::memcmp(found, magic, sizeof(magic)) != 0 || count > (size - header_bytes) / sizeof(Entry) ||
+            size != header_bytes + count * sizeof(Entry))
+            return false;
+        std::vector<Entry> entries(count);
+        file.read(reinterpret_cast<char *>(entries.data()), static_cast<std::streamsize>(count * sizeof(Entry)));
+        if (file.gcount() != static_cast<std::streamsize>(count * sizeof(Entry)))
+            return false;
+        values.reserve(count);
+        for (const Entry &e : entries)
+            values[e.key] = e.value;
+        return true;
+    }
+
+   private:
+    struct Entry {
+        uint64_t key;
+        double value;
+    };
+    static_assert(sizeof(Entry) == 16, "solution entries must stay 16 bytes");
+    static_assert(GameState::exact_key, "a table keyed on a hashed key() could mix positions up silently");
+    static constexpr char magic[8]        = {'K', 'B', 'S', 'O', 'L', 'V', '1', '\0'};
+    static constexpr uint64_t header_bytes = sizeof(magic) + sizeof(uint64_t);
+
+    std::unordered_map<uint64_t, double> values;
+};
+
+/**
+ * Solver
+ *
+ * Description:
+ *      Offline retrograde solver. Enumerates every position reachable from a
+ *      root, groups them by the number of dice on both boards and solves the
+ *      groups from fullest to emptiest. A move never lowers the dice count, so
+ *      a group only depends on itself (through removals) and on groups that
+ *      are already solved. Removals can repeat a position, so each group is
+ *      swept until no value changes. Positions are stored once per column
+ *      permutation (see CanonicalKey). Enumeration and sweeps are split across
+ *      threads.
+ *
+ * Public Methods:
+ *      - Solver(unsigned threads = 0, size_t max_states = 50000000)
+ *      - bool solve(const GameState &root, SolutionTable &table)
+ *      - size_t states() const : Number of non-terminal states found by the last solve.
+ *
+ * Usage:
+ *      Solver solver;
+ *      SolutionTable table;
+ *      if (solver.solve(root, table)) table.save("solution.bin");
+ */
+class Solver {
+   public:
+    Solver(unsigned threads = 0, size_t max_states = 50000000) : max_states(max_states) {
+        thread_count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    // Returns false if the reachable space is larger than max_states
+    bool solve(const GameState &root, SolutionTable &table) {
+        if (!enumerate(root))
+            return false;
+
+        std::vector<double> value(keys.size(), 0.5);
+        std::vector<double> next(keys.size(), 0.5);
+
+        for (int dice = max_dice; dice >= 0; --dice) {
+            const std::vector<uint32_t> &layer = layers[dice];
+            if (layer.empty())
+                continue;
+            for (int sweep = 0; sweep < max_sweeps; ++sweep) {
+                std::vector<double> deltas(thread_count, 0.0);
+                parallel_for(layer.size(), [&](size_t begin, size_t end, unsigned t) {
+                    double d = 0.0;
+                    for (size_t i = begin; i < end; ++i) {
+                        uint32_t idx = layer[i];
+                        next[idx]    = backup(GameState::from_key(keys[idx]), value);
+                        d            = std::max(d, std::fabs(next[idx] - value[idx]));
+                    }
+                    deltas[t] = d;
+                });
+                for (uint32_t idx : layer)
+                    value[idx] = next[idx];
+                if (*std::max_element(deltas.begin(), deltas.end()) <= tolerance)
+                    break;
+            }
+        }
+
+        table.reserve(keys.size());
+        for (size_t i = 0; i < keys.size(); ++i)
+            table.set(keys[i], value[i]);
+        return true;
+    }
+
+    size_t states() const { return keys.size(); }
+
+   private:
+    static const int max_sweeps = 100000;
+    static const int max_dice   = 2 * GameState::rows * GameState::cols;
+    static constexpr double tolerance = 1e-15;
+
+    unsigned thread_count;
+    size_t max_states;
+    std::vector<uint64_t> keys;                    // non-terminal states
+    std::unordered_map<uint64_t, uint32_t> index;  // key -> position in keys
+    std::vector<std::vector<uint32_t> > layers = std::vector<std::vector<uint32_t> >(max_dice + 1);
+
+    // Expected value for the side to move: average over rolls of the best column
+    double backup(const GameState &s, const std::vector<double> &value) const {
+        double total = 0.0;
+        for (int roll = 1; roll <= GameState::sides; ++roll) {
+            double best = 0.0;
+            for (int col = 0; col < GameState::cols; ++col) {
+                if (s.column_full(s.turn, col))
+                    continue;
+                GameState child = s;
+                child.place(col, roll);
+                double v = child.is_over() ? SolutionTable::terminal_value(child, s.turn)
+                                           : 1.0 - value[index.at(child.canonical().key)];
+                best = std::max(best, v);
+            }
+            total += best;
+        }
+        return total / GameState::sides;
+    }
+
+    bool enumerate(const GameState &root) {
+        keys.clear();
+        index.clear();
+        for (auto &layer : layers)
+            layer.clear();
+        if (root.is_over())
+            return true;
+
+        std::vector<uint64_t> frontier = {root.canonical().key};
+        add(frontier[0]);
+        while (!frontier.empty()) {
+            std::vector<std::vector<uint64_t> > found(thread_count);
+            parallel_for(frontier.size(), [&](size_t begin, size_t end, unsigned t) {
+                std::unordered_set<uint64_t> local;
+                for (size_t i = begin; i < end; ++i) {
+                    GameState s = GameState::from_key(frontier[i]);
+                    for (int roll = 1; roll <= GameState::sides; ++roll) {
+                        for (int col = 0; col < GameState::cols; ++col) {
+                            if (s.column_full(s.turn, col))
+                                continue;
+                            GameState child = s;
+                            child.place(col, roll);
+                            if (!child.is_over())
+                                local.insert(child.canonical().key);
+                        }
+                    }
+                }
+                found[t].assign(local.begin(), local.end());
+            });
+            frontier.clear();
+            for (const auto &part : found) {
+                for (uint64_t k : part) {
+                    if (index.count(k))
+                        continue;
+                    if (keys.size() >= max_states)
+                        return false;
+                    add(k);
+                    frontier.push_back(k);
+                }
+            }
+        }
+        return true;
+    }
+
+    void add(uint64_t k) {
+        index[k] = static_cast<uint32_t>(keys.size());
+        layers[GameState::from_key(k).dice_count()].push_back(static_cast<uint32_t>(keys.size()));
+        keys.push_back(k);
+    }
+
+    template <typename Fn>
+    void parallel_for(size_t n, Fn fn) const {
+        unsigned workers = static_cast<unsigned>(std::min<size_t>(thread_count, std::max<size_t>(n, 1)));
+        size_t chunk     = (n + workers - 1) / workers;
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < workers; ++t)
+            pool.emplace_back(fn, std::min(n, t * chunk), std::min(n, (t + 1) * chunk), t);
+        fn(0, std::min(n, chunk), 0u);
+        for (auto &th : pool)
+            th.join();
+    }
+};
+
+/**
+ * SolverAgent
+ *
+ * Description:
+ *      Plays the exact best move from a solution table while the position is
+ *      in it, which is every position reachable from where the solver started,
+ *      and asks the fallback agent otherwise. The table is shared read-only
+ *      between clones.
+ *
+ * Usage:
+ *      auto table = std::make_shared<SolutionTable>();
+ *      table->load("solution.bin");
+ *      std::unique_ptr<Agent> bot(new SolverAgent(table, std::unique_ptr<Agent>(new ExpectimaxAgent(3))));
+ */
+class SolverAgent : public Agent {
+   public:
+    SolverAgent(std::shared_ptr<const SolutionTable> table, std::unique_ptr<Agent> fallback)
+        : table(std::move(table)), fallback(std::move(fallback)) {}
+
+    int choose(const GameState &state, int roll) override {
+        int col = table->contains(state) ? table->best_move(state, roll) : -1;
+        return col >= 0 ? col : fallback->choose(state, roll);
+    }
+
+    std::string name() const override { return fallback->name() + "+solver"; }
+
+    std::unique_ptr<Agent> clone() const override {
+        return std::unique_ptr<Agent>(new SolverAgent(table, fallback->clone()));
+    }
+
+   private:
+    std::shared_ptr<const SolutionTable> table;
+    std::unique_ptr<Agent> fallback;
+};
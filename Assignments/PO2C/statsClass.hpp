@@ -0,0 +1,358 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+/**
+ * Histogram
+ *
+ * Description:
+ *      Fixed-bucket histogram in the HDR style: values below 64 get a bucket
+ *      each, above that every power of two is split into 32 equal buckets, so
+ *      any value is kept to within about 3% with 896 buckets covering 0 to
+ *      2^32. Recording is one index computation and an increment; nothing is
+ *      allocated, and two histograms merge by adding their buckets.
+ *
+ * Public Methods:
+ *      - void record(uint64_t value, uint64_t n = 1)
+ *      - void merge(const Histogram& other)
+ *      - uint64_t count() const / min() const / max() const
+ *      - double mean() const
+ *      - uint64_t percentile(double p) const  : Highest value of the bucket holding the p-th percentile.
+ *      - static int bucket_of(uint64_t value) / static uint64_t bucket_low(int b) / bucket_high(int b)
+ *
+ * Usage:
+ *      Histogram h;
+ *      h.record(42);
+ *      uint64_t p99 = h.percentile(99.0);
+ */
+class Histogram {
+   public:
+    static constexpr int sub_bits       = 5;
+    static constexpr int sub_count      = 1 << sub_bits;
+    static constexpr int buckets        = (32 - sub_bits + 1) * sub_count;
+    static constexpr uint64_t max_value = 0xFFFFFFFFull;
+
+    static int bucket_of(uint64_t value) {
+        if (value > max_value)
+            value = max_value;
+        if (value < 2 * sub_count)
+            return static_cast<int>(value);
+        int high = 63 - __builtin_clzll(value);
+        int step = high - sub_bits;
+        return (step + 1) * sub_count + static_cast<int>((value >> step) - sub_count);
+    }
+
+    static uint64_t bucket_low(int b) {
+        if (b < 2 * sub_count)
+            return static_cast<uint64_t>(b);
+        int step = b / sub_count - 1;
+        return static_cast<uint64_t>(sub_count + b % sub_count) << step;
+    }
+
+    static uint64_t bucket_high(int b) {
+        if (b < 2 * sub_count)
+            return static_cast<uint64_t>(b);
+        int step = b / sub_count - 1;
+        return bucket_low(b) + (1ull << step) - 1;
+    }
+
+    void record(uint64_t value, uint64_t n = 1) {
+        counts[bucket_of(value)] += n;
+        total += n;
+        sum += value * n;
+        low  = std::min(low, value);
+        high = std::max(high, value);
+    }
+
+    void merge(const Histogram &other) {
+        for (int b = 0; b < buckets; ++b)
+            counts[b] += other.counts[b];
+        total += other.total;
+        sum += other.sum;
+        low  = std::min(low, other.low);
+        high = std::max(high, other.high);
+    }
+
+    // Used when summing shards whose buckets were read one at a time
+    void add_bucket(int b, uint64_t n) {
+        counts[b] += n;
+        total += n;
+    }
+    void add_summary(uint64_t value_sum, uint64_t min_value, uint64_t max_value_seen) {
+        sum += value_sum;
+        low  = std::min(low, min_value);
+        high = std::max(high, max_value_seen);
+    }
+
+    uint64_t count() const { return total; }
+    uint64_t bucket_count(int b) const { return counts[b]; }
+    uint64_t min() const { return total ? low : 0; }
+    uint64_t max() const { return high; }
+    double mean() const { return total ? static_cast<double>(sum) / static_cast<double>(total) : 0.0; }
+
+    uint64_t percentile(double p) const {
+        if (!total)
+            return 0;
+        uint64_t rank = static_cast<uint64_t>(std::ceil(p / 100.0 * static_cast<double>(total)));
+        rank          = std::max<uint64_t>(rank, 1);
+        uint64_t seen = 0;
+        for (int b = 0; b < buckets; ++b) {
+            seen += counts[b];
+            if (seen >= rank)
+                return std::min(bucket_high(b), high);
+        }
+        return high;
+    }
+
+   private:
+    std::array<uint64_t, buckets> counts{};
+    uint64_t total = 0;
+    uint64_t sum   = 0;
+    uint64_t low   = UINT64_MAX;
+    uint64_t high  = 0;
+};
+
+/**
+ * ConcurrentHistogram
+ *
+ * Description:
+ *      Histogram with one writer thread and any number of readers. The
+ *      writer bumps its buckets with a relaxed load and store (no locked
+ *      instruction, no lock), and readers add the buckets into a Histogram
+ *      whenever they like. A reader racing the writer may miss the last few
+ *      records, never more, and never sees a torn count.
+ */
+class ConcurrentHistogram {
+   public:
+    void record(uint64_t value) {
+        bump(counts[Histogram::bucket_of(value)], 1);
+        bump(sum, value);
+        if (value < low.load(std::memory_order_relaxed))
+            low.store(value, std::memory_order_relaxed);
+        if (value > high.load(std::memory_order_relaxed))
+            high.store(value, std::memory_order_relaxed);
+    }
+
+    void add_to(Histogram &out) const {
+        for (int b = 0; b < Histogram::buckets; ++b) {
+            uint64_t n = counts[b].load(std::memory_order_relaxed);
+            if (n)
+                out.add_bucket(b, n);
+        }
+        out.add_summary(sum.load(std::memory_order_relaxed), low.load(std::memory_order_relaxed),
+                        high.load(std::memory_order_relaxed));
+    }
+
+   private:
+    std::array<std::atomic<uint64_t>, Histogram::buckets> counts{};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> low{UINT64_MAX};
+    std::atomic<uint64_t> high{0};
+
+    static void bump(std::atomic<uint64_t> &a, uint64_t n) {
+        a.store(a.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * GameStats
+ *
+ * Description:
+ *      Distributions over finished games: every final score, the winning
+ *      margin, the game length in moves and how many dice each column held
+ *      at the end, plus win/tie counts by seat.
+ *
+ *      Each recording thread gets its own shard the first time it records
+ *      (found again through a thread_local cache), so recording never
+ *      contends. Shards are linked into a lock-free list with a CAS push and
+ *      live until the GameStats is destroyed. merged() sums all shards into
+ *      plain histograms and can run while games are still being recorded.
+ *
+ * Public Methods:
+ *      - void record(const State& final_state, int moves) : From any thread.
+ *      - Summary merged() const                            : Current totals.
+ *      - bool write_csv(const std::string& path) const     : metric,low,high,count rows.
+ *      - bool write_json(const std::string& path) const    : Summary statistics and buckets.
+ *
+ * Usage:
+ *      GameStats stats;
+ *      stats.record(state, moves);       // in every worker
+ *      stats.merged().score.percentile(50);
+ *      stats.write_json("stats.json");
+ */
+class GameStats {
+   public:
+    static constexpr int max_cols = 8;
+
+    struct Summary {
+        Histogram score;           // both players' final scores
+        Histogram margin;          // winner's score minus loser's
+        Histogram length;          // dice placed in the game
+        Histogram fill[max_cols];  // dice left in each column of each board
+        int cols         = 0;
+        uint64_t games   = 0;
+        uint64_t wins[2] = {0, 0};
+        uint64_t ties    = 0;
+    };
+
+    GameStats() : id(next_id().fetch_add(1) + 1) {}
+    GameStats(const GameStats &)            = delete;
+    GameStats &operator=(const GameStats &) = delete;
+
+    ~GameStats() {
+        Shard *s = head.load();
+        while (s) {
+            Shard *next = s->next;
+            delete s;
+            s = next;
+        }
+    }
+
+    template <typename State>
+    void record(const State &s, int moves) {
+        static_assert(State::cols <= max_cols, "GameStats tracks at most max_cols columns");
+        Shard &shard = local();
+        int a = s.score(0), b = s.score(1);
+        shard.score.record(static_cast<uint64_t>(a));
+        shard.score.record(static_cast<uint64_t>(b));
+        shard.margin.record(static_cast<uint64_t>(a > b ? a - b : b - a));
+        shard.length.record(static_cast<uint64_t>(moves));
+        for (int p = 0; p < 2; ++p) {
+            for (int col = 0; col < State::cols; ++col) {
+                int dice = 0;
+                for (int row = 0; row < State::rows; ++row)
+                    dice += s.grid[p][col][row] != 0;
+                shard.fill[col].record(static_cast<uint64_t>(dice));
+            }
+        }
+        int result = a > b ? 0 : (b > a ? 1 : 2);
+        shard.results[result].store(shard.results[result].load(std::memory_order_relaxed) + 1,
+                                    std::memory_order_relaxed);
+        if (State::cols > shard.cols.load(std::memory_order_relaxed))
+            shard.cols.store(State::cols, std::memory_order_relaxed);
+    }
+
+    Summary merged() const {
+        Summary out;
+        for (const Shard *s = head.load(std::memory_order_acquire); s; s = s->next) {
+            s->score.add_to(out.score);
+            s->margin.add_to(out.margin);
+            s->length.add_to(out.length);
+            for (int col = 0; col < max_cols; ++col)
+                s->fill[col].add_to(out.fill[col]);
+            out.cols = std::max(out.cols, s->cols.load(std::memory_order_relaxed));
+            out.wins[0] += s->results[0].load(std::memory_order_relaxed);
+            out.wins[1] += s->results[1].load(std::memory_order_relaxed);
+            out.ties += s->results[2].load(std::memory_order_relaxed);
+        }
+        out.games = out.wins[0] + out.wins[1] + out.ties;
+        return out;
+    }
+
+    bool write_csv(const std::string &path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        Summary sum = merged();
+        file << "metric,low,high,count\n";
+        for (const auto &m : metrics(sum)) {
+            for (int b = 0; b < Histogram::buckets; ++b) {
+                if (m.second->bucket_count(b))
+                    file << m.first << ',' << Histogram::bucket_low(b) << ',' << Histogram::bucket_high(b) << ','
+                         << m.second->bucket_count(b) << '\n';
+            }
+        }
+        return file.good();
+    }
+
+    bool write_json(const std::string &path) const {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file.is_open())
+            return false;
+        Summary sum = merged();
+        file << "{\n  \"games\": " << sum.games << ",\n  \"wins\": [" << sum.wins[0] << ", " << sum.wins[1]
+             << "],\n  \"ties\": " << sum.ties << ",\n  \"metrics\": {";
+        bool first = true;
+        for (const auto &m : metrics(sum)) {
+            const Histogram &h = *m.second;
+            file << (first ? "\n" : ",\n") << "    \"" << m.first << "\": {\"count\": " << h.count()
+                 << ", \"min\": " << h.min() << ", \"max\": " << h.max() << ", \"mean\": " << h.mean()
+                 << ", \"p50\": " << h.percentile(50) << ", \"p90\": " << h.percentile(90)
+                 << ", \"p99\": " << h.percentile(99) << ", \"p99.9\": " << h.percentile(99.9) << ", \"buckets\": [";
+            bool first_bucket = true;
+            for (int b = 0; b < Histogram::buckets; ++b) {
+                if (!h.bucket_count(b))
+                    continue;
+                file << (first_bucket ? "" : ", ") << '[' << Histogram::bucket_low(b) << ", "
+                     << Histogram::bucket_high(b) << ", " << h.bucket_count(b) << ']';
+                first_bucket = false;
+            }
+            file << "]}";
+            first = false;
+        }
+        file << "\n  }\n}\n";
+        return file.good();
+    }
+
+   private:
+    struct Shard {
+        std::thread::id owner;
+        Shard *next = nullptr;
+        ConcurrentHistogram score, margin, length;
+        ConcurrentHistogram fill[max_cols];
+        std::atomic<uint64_t> results[3] = {};  // first seat wins, second seat wins, ties
+        std::atomic<int> cols{0};
+    };
+
+    const uint64_t id;  // never reused, unlike the address, so the thread cache cannot go stale
+    std::atomic<Shard *> head{nullptr};
+
+    static std::atomic<uint64_t> &next_id() {
+        static std::atomic<uint64_t> counter{0};
+        return counter;
+    }
+
+    Shard &local() {
+        // one cached shard per thread; a thread recording into several
+        // GameStats objects falls back to searching the list
+        thread_local uint64_t cached_id  = 0;
+        thread_local Shard *cached_shard = nullptr;
+        if (cached_id == id)
+            return *cached_shard;
+
+        std::thread::id me = std::this_thread::get_id();
+        Shard *found       = nullptr;
+        for (Shard *s = head.load(std::memory_order_acquire); s && !found; s = s->next) {
+            if (s->owner == me)
+                found = s;
+        }
+        if (!found) {
+            found        = new Shard();
+            found->owner = me;
+            found->next  = head.load(std::memory_order_relaxed);
+            while (!head.compare_exchange_weak(found->next, found, std::memory_order_release, std::memory_order_relaxed)) {
+            }
+        }
+        cached_id    = id;
+        cached_shard = found;
+        return *found;
+    }
+
+    // The metrics worth writing out: the fixed three plus one per column in use
+    static std::vector<std::pair<std::string, const Histogram *> > metrics(const Summary &sum) {
+        std::vector<std::pair<std::string, const Histogram *> > out = {
+            {"score", &sum.score}, {"margin", &sum.margin}, {"length", &sum.length}};
+        for (int col = 0; col < sum.cols; ++col)
+            out.push_back({"fill_col" + std::to_string(col + 1), &sum.fill[col]});
+        return out;
+    }
+};
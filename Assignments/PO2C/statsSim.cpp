@@ -0,0 +1,171 @@
+#include "statsClass.hpp"     // histograms and game statistics
+#include "strategyClass.hpp"  // strategies and play_game
+#include <atomic>             // work counter
+#include <chrono>             // timing
+#include <cstdio>             // printf
+#include <cstdlib>            // strtoul
+#include <map>                // baseline collector
+#include <mutex>              // baseline collector
+#include <string>             // string data structure
+#include <thread>             // worker threads
+#include <vector>             // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Statistics Simulator
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Plays millions of greedy vs random games on every core and collects
+*        score, margin, length and column fill distributions with GameStats,
+*        printing merged percentiles while it runs. The same games are then
+*        collected into std::map under a mutex to show what that costs.
+*        Results are written as CSV and JSON.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o statsSim statsSim.cpp boardVariants.cpp`
+*        - Run with `./statsSim [games] [threads] [out_prefix]`
+*        - Writes <out_prefix>.csv and <out_prefix>.json (default prefix "stats")
+*
+*  Files:             statsSim.cpp      : simulation driver
+*                     statsClass.hpp    : histograms and GameStats
+*                     strategyClass.hpp : the players
+*****************************************************************************/
+
+/**
+ * simulate
+ *
+ * Description:
+ *      Plays `games` games split over `threads` workers and hands every
+ *      finished game to `collect`. The calling thread runs `report` every
+ *      second until the workers finish.
+ *
+ * Returns:
+ *      double : seconds taken
+ */
+template <typename Collect, typename Report>
+double simulate(uint64_t games, unsigned threads, Collect collect, Report report) {
+    std::atomic<uint64_t> next{0};
+    std::atomic<unsigned> running{threads};
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (unsigned t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t]() {
+            GreedyStrategy greedy;
+            RandomStrategy random(t + 1);
+            GameState final_state;
+            int moves = 0;
+            // claim games in blocks so the counter is not the bottleneck
+            for (uint64_t base = next.fetch_add(1024); base < games; base = next.fetch_add(1024)) {
+                for (uint64_t g = base; g < std::min(games, base + 1024); ++g) {
+                    if (g % 2)
+                        play_game(greedy, random, g, &final_state, &moves);
+                    else
+                        play_game(random, greedy, g, &final_state, &moves);
+                    collect(final_state, moves);
+                }
+            }
+            --running;
+        });
+    }
+    auto last = start;
+    while (running) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        if (std::chrono::steady_clock::now() - last >= std::chrono::seconds(1)) {
+            report();
+            last = std::chrono::steady_clock::now();
+        }
+    }
+    for (auto &th : pool)
+        th.join();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+void print_metric(const char *name, const Histogram &h) {
+    std::printf("%-9s n=%-9llu mean %7.2f  min %3llu  p50 %3llu  p90 %3llu  p99 %3llu  max %3llu\n", name,
+                static_cast<unsigned long long>(h.count()), h.mean(), static_cast<unsigned long long>(h.min()),
+                static_cast<unsigned long long>(h.percentile(50)), static_cast<unsigned long long>(h.percentile(90)),
+                static_cast<unsigned long long>(h.percentile(99)), static_cast<unsigned long long>(h.max()));
+}
+
+int main(int argc, char **argv) {
+    uint64_t games     = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2000000;
+    unsigned threads   = argc > 2 ? static_cast<unsigned>(std::strtoul(argv[2], nullptr, 10)) : 0;
+    std::string prefix = argc > 3 ? argv[3] : "stats";
+    if (!threads)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+
+    GameStats stats;
+    double secs = simulate(
+        games, threads, [&](const GameState &s, int moves) { stats.record(s, moves); },
+        [&]() {
+            GameStats::Summary now = stats.merged();
+            std::printf("%llu games, median score %llu\n", static_cast<unsigned long long>(now.games),
+                        static_cast<unsigned long long>(now.score.percentile(50)));
+        });
+    std::printf("GameStats: %.0f games/s\n", games / secs);
+
+    // the same collection through a mutex and std::map, for comparison
+    std::mutex lock;
+    std::map<std::string, std::map<int, uint64_t> > baseline;
+    double base_secs = simulate(
+        games, threads,
+        [&](const GameState &s, int moves) {
+            std::lock_guard<std::mutex> hold(lock);
+            int a = s.score(0), b = s.score(1);
+            baseline["score"][a]++;
+            baseline["score"][b]++;
+            baseline["margin"][a > b ? a - b : b - a]++;
+            baseline["length"][moves]++;
+        },
+        []() {});
+    std::printf("mutex + std::map: %.0f games/s\n", games / base_secs);
+
+    // collection alone, with no games in between to hide its cost
+    GameState sample;
+    GreedyStrategy first, second;
+    play_game(first, second, 1, &sample);
+    GameStats scratch;
+    auto time_records = [&](auto &&collect) {
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < threads; ++t)
+            pool.emplace_back([&]() {
+                for (int i = 0; i < 1000000; ++i)
+                    collect(sample, 20 + i % 8);
+            });
+        for (auto &th : pool)
+            th.join();
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() /
+               (1e6 * threads);
+    };
+    double ns_stats = time_records([&](const GameState &s, int moves) { scratch.record(s, moves); });
+    double ns_map   = time_records([&](const GameState &s, int moves) {
+        std::lock_guard<std::mutex> hold(lock);
+        int a = s.score(0), b = s.score(1);
+        baseline["score"][a]++;
+        baseline["score"][b]++;
+        baseline["margin"][a > b ? a - b : b - a]++;
+        baseline["length"][moves]++;
+    });
+    std::printf("per game recorded: GameStats %.1f ns, mutex + std::map %.1f ns\n\n", ns_stats, ns_map);
+
+    GameStats::Summary sum = stats.merged();
+    std::printf("%llu games: seat 1 won %llu, seat 2 won %llu, %llu ties\n", static_cast<unsigned long long>(sum.games),
+                static_cast<unsigned long long>(sum.wins[0]), static_cast<unsigned long long>(sum.wins[1]),
+                static_cast<unsigned long long>(sum.ties));
+    print_metric("score", sum.score);
+    print_metric("margin", sum.margin);
+    print_metric("length", sum.length);
+    for (int col = 0; col < sum.cols; ++col)
+        print_metric(("fill_col" + std::to_string(col + 1)).c_str(), sum.fill[col]);
+
+    if (!stats.write_csv(prefix + ".csv") || !stats.write_json(prefix + ".json")) {
+        std::fprintf(stderr, "Unable to write %s.csv / %s.json\n", prefix.c_str(), prefix.c_str());
+        return 1;
+    }
+    return 0;
+}
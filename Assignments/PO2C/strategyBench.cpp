@@ -0,0 +1,110 @@
+#include "strategyClass.hpp"  // compile-time and run-time strategies
+#include <algorithm>          // max
+#include <chrono>             // timing
+#include <cstdint>            // checksums
+#include <cstdio>             // printf
+#include <cstdlib>            // strtoul
+#include <memory>             // unique_ptr
+#include <string>             // string data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Strategy Dispatch Benchmark
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Plays the same seeded games twice, once through the compile-time
+*        (CRTP) strategies and once through BasicAgent virtual calls, and
+*        prints games/sec for each. Both runs must produce the same games:
+*        the points and a checksum of every final position are compared, and
+*        the program exits with 1 if any pairing differs.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -o strategyBench strategyBench.cpp boardVariants.cpp`
+*        - Run with `./strategyBench [games]`
+*
+*  Files:             strategyBench.cpp : benchmark driver
+*                     strategyClass.hpp : strategies, agents and play_game
+*****************************************************************************/
+
+/**
+ * make_agent
+ *
+ * Description:
+ *      Builds an agent from its name. Kept out of line so the compiler cannot
+ *      see the concrete type at the call sites and devirtualize them.
+ *
+ * Params:
+ *      const std::string& name : "random" or "greedy"
+ *
+ * Returns:
+ *      std::unique_ptr<Agent> : the agent
+ */
+__attribute__((noinline)) std::unique_ptr<Agent> make_agent(const std::string &name) {
+    if (name == "random")
+        return std::unique_ptr<Agent>(new RandomAgent());
+    return std::unique_ptr<Agent>(new GreedyAgent());
+}
+
+/**
+ * time_games
+ *
+ * Description:
+ *      Plays `games` games between two players and reports the rate.
+ *
+ * Returns:
+ *      double : games per second; `points` receives the first player's total
+ *               and `checksum` a hash of every final position
+ */
+template <typename First, typename Second>
+double time_games(First &first, Second &second, int games, double &points, uint64_t &checksum) {
+    points     = 0.0;
+    checksum   = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int g = 0; g < games; ++g) {
+        GameState last;
+        points += play_game(first, second, static_cast<uint64_t>(g), &last);
+        checksum = (checksum ^ last.key()) * 0x100000001B3ull;
+    }
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return games / secs;
+}
+
+// Returns false if the two forms played different games
+template <typename A, typename B>
+bool compare(const std::string &a_name, const std::string &b_name, int games) {
+    std::unique_ptr<Agent> a_virtual = make_agent(a_name);
+    std::unique_ptr<Agent> b_virtual = make_agent(b_name);
+
+    // alternate the two forms and keep the best of each; fresh players every
+    // run so the random streams, and so the games, are identical
+    double static_points = 0, virtual_points = 0, static_rate = 0, virtual_rate = 0;
+    uint64_t static_sum = 0, virtual_sum = 0;
+    bool same = true;
+    for (int rep = 0; rep < 5; ++rep) {
+        A a_static;
+        B b_static;
+        std::unique_ptr<Agent> a = a_virtual->clone(), b = b_virtual->clone();
+        static_rate  = std::max(static_rate, time_games(a_static, b_static, games, static_points, static_sum));
+        virtual_rate = std::max(virtual_rate, time_games(*a, *b, games, virtual_points, virtual_sum));
+        same         = same && static_points == virtual_points && static_sum == virtual_sum;
+    }
+    std::printf("%-8s vs %-8s %12.0f %12.0f %7.2fx %10.1f %10.1f  %016llx %s\n", a_name.c_str(), b_name.c_str(),
+                static_rate, virtual_rate, static_rate / virtual_rate, static_points, virtual_points,
+                static_cast<unsigned long long>(static_sum), same ? "same" : "DIFFERENT");
+    return same;
+}
+
+int main(int argc, char **argv) {
+    int games = argc > 1 ? static_cast<int>(std::strtoul(argv[1], nullptr, 10)) : 1000000;
+
+    std::printf("%-20s %12s %12s %8s %10s %10s  %-16s %s\n", "pairing", "crtp g/s", "virtual g/s", "speedup",
+                "crtp pts", "virt pts", "checksum", "games");
+    bool same = compare<RandomStrategy, RandomStrategy>("random", "random", games);
+    same      = compare<GreedyStrategy, RandomStrategy>("greedy", "random", games) && same;
+    same      = compare<GreedyStrategy, GreedyStrategy>("greedy", "greedy", games) && same;
+    return same ? 0 : 1;
+}
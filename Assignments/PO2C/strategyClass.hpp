@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "boardState.hpp"
+
+/**
+ * Strategy
+ *
+ * Description:
+ *      Compile-time strategy base (CRTP). A strategy derives from
+ *      Strategy<Itself> and provides `pick(state, roll)` and `name()`;
+ *      callers go through choose(), which resolves to the derived pick() at
+ *      compile time. Code templated on the strategy type (simulations,
+ *      play_game below) therefore inlines the whole move choice with no
+ *      virtual call. `pick` is a member template so one strategy works for
+ *      every BasicGameState variant.
+ *
+ * Public Methods:
+ *      - int choose(const State& state, int roll) : Column to play (always legal).
+ *
+ * Usage:
+ *      struct LeftmostStrategy : Strategy<LeftmostStrategy> {
+ *          template <typename State>
+ *          int pick(const State &s, int) { ... }
+ *          std::string name() const { return "leftmost"; }
+ *      };
+ */
+template <typename Derived>
+class Strategy {
+   public:
+    template <typename State>
+    int choose(const State &state, int roll) {
+        return static_cast<Derived &>(*this).pick(state, roll);
+    }
+};
+
+/**
+ * RandomStrategy
+ *
+ * Description:
+ *      Plays a uniformly random legal column. The baseline every other
+ *      player should beat.
+ */
+class RandomStrategy : public Strategy<RandomStrategy> {
+   public:
+    explicit RandomStrategy(uint64_t seed = 1) : rng(seed | 1) {}
+
+    template <typename State>
+    int pick(const State &state, int) {
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+        int col = static_cast<int>(rng % State::cols);
+        while (state.column_full(state.turn, col))
+            col = (col + 1) % State::cols;
+        return col;
+    }
+
+    std::string name() const { return "random"; }
+
+   private:
+    uint64_t rng;
+};
+
+/**
+ * GreedyStrategy
+ *
+ * Description:
+ *      Plays the column that leaves the best score difference right after the
+ *      move, which rewards both matching its own dice and knocking out the
+ *      opponent's. Ties go to the lowest column.
+ */
+class GreedyStrategy : public Strategy<GreedyStrategy> {
+   public:
+    template <typename State>
+    int pick(const State &state, int roll) {
+        State s  = state;
+        int best = -1, best_margin = 0;
+        for (int col = 0; col < State::cols; ++col) {
+            if (s.column_full(s.turn, col))
+                continue;
+            auto undo  = s.make_move(col, roll);
+            int margin = s.score(state.turn) - s.score(state.turn ^ 1);
+            s.unmake_move(undo);
+            if (best < 0 || margin > best_margin) {
+                best        = col;
+                best_margin = margin;
+            }
+        }
+        return best;
+    }
+
+    std::string name() const { return "greedy"; }
+};
+
+/**
+ * ExpectimaxStrategy
+ *
+ * Description:
+ *      Depth-limited expectimax: the mover maximizes, die rolls are averaged,
+ *      and positions at the depth limit are scored by the score difference
+ *      (finished games add a large win/loss bonus). The search runs depth
+ *      first on a single copy of the state with make_move / unmake_move, so
+ *      it never allocates and never copies a board. Depth counts placed
+ *      dice; depth 3 looks at the reply and our next move.
+ */
+class ExpectimaxStrategy : public Strategy<ExpectimaxStrategy> {
+   public:
+    explicit ExpectimaxStrategy(int depth = 3) : depth(depth) {}
+
+    template <typename State>
+    int pick(const State &state, int roll) {
+        State s           = state;
+        int best          = -1;
+        double best_value = 0.0;
+        for (int col = 0; col < State::cols; ++col) {
+            if (s.column_full(s.turn, col))
+                continue;
+            auto undo    = s.make_move(col, roll);
+            double value = -expected(s, depth - 1);
+            s.unmake_move(undo);
+            if (best < 0 || value > best_value) {
+                best       = col;
+                best_value = value;
+            }
+        }
+        return best;
+    }
+
+    std::string name() const { return "expectimax-" + std::to_string(depth); }
+
+   private:
+    int depth;
+
+    // Value for the side to move, before it rolls
+    template <typename State>
+    static double expected(State &s, int depth) {
+        if (s.is_over() || depth <= 0) {
+            int margin = s.score(s.turn) - s.score(s.turn ^ 1);
+            if (!s.is_over())
+                return margin;
+            return margin + (margin > 0 ? 1000.0 : (margin < 0 ? -1000.0 : 0.0));
+        }
+        double total = 0.0;
+        for (int roll = 1; roll <= State::sides; ++roll) {
+            double best = -1e9;
+            for (int col = 0; col < State::cols; ++col) {
+                if (s.column_full(s.turn, col))
+                    continue;
+                auto undo = s.make_move(col, roll);
+                best      = std::max(best, -expected(s, depth - 1));
+                s.unmake_move(undo);
+            }
+            total += best;
+        }
+        return total / State::sides;
+    }
+};
+
+/**
+ * BasicAgent
+ *
+ * Description:
+ *      Run-time strategy interface, for code that picks players while running
+ *      (the ncurses game, tournaments). Agents may keep state between moves
+ *      (random streams, search trees), so anything that plays games in
+ *      parallel calls clone() to give each thread its own copy. `Agent` is
+ *      the interface for the standard game.
+ *
+ * Public Methods:
+ *      - int choose(const State& state, int roll)   : Column to play (must be legal).
+ *      - std::string name() const                   : Label used in standings.
+ *      - std::unique_ptr<BasicAgent> clone() const  : Fresh copy for another thread.
+ *
+ * Usage:
+ *      std::unique_ptr<Agent> bot(new GreedyAgent());
+ *      int column = bot->choose(state, roll);
+ */
+template <typename State>
+class BasicAgent {
+   public:
+    virtual ~BasicAgent() {}
+    virtual int choose(const State &state, int roll)  = 0;
+    virtual std::string name() const                  = 0;
+    virtual std::unique_ptr<BasicAgent> clone() const = 0;
+};
+
+using Agent = BasicAgent<GameState>;
+
+/**
+ * StrategyAgent
+ *
+ * Description:
+ *      Wraps a compile-time strategy in the run-time interface, so every
+ *      strategy is written once and used both ways.
+ *
+ * Usage:
+ *      std::unique_ptr<Agent> bot(new StrategyAgent<RandomStrategy>(42));
+ */
+template <typename S, typename State = GameState>
+class StrategyAgent : public BasicAgent<State> {
+   public:
+    template <typename... Args>
+    explicit StrategyAgent(Args &&...args) : strategy(std::forward<Args>(args)...) {}
+
+    int choose(const State &state, int roll) override { return strategy.choose(state, roll); }
+    std::string name() const override { return strategy.name(); }
+    std::unique_ptr<BasicAgent<State> > clone() const override {
+        return std::unique_ptr<BasicAgent<State> >(new StrategyAgent(strategy));
+    }
+
+   private:
+    S strategy;
+};
+
+using RandomAgent     = StrategyAgent<RandomStrategy>;
+using GreedyAgent     = StrategyAgent<GreedyStrategy>;
+using ExpectimaxAgent = StrategyAgent<ExpectimaxStrategy>;
+
+/**
+ * play_game
+ *
+ * Description:
+ *      Plays one game on dice drawn from `seed` and returns the result for
+ *      the player moving first. Works with either form: pass strategies (or
+ *      references to concrete strategy types) for a fully inlined loop, or
+ *      BasicAgent references for virtual dispatch.
+ *
+ * Params:
+ *      First& first   : player moving first
+ *      Second& second : player moving second
+ *      uint64_t seed  : dice stream; the same seed gives the same rolls
+ *      State* final_state : if given, receives the finished position
+ *      int* moves         : if given, receives the number of dice placed
+ *
+ * Returns:
+ *      double : 1 if `first` wins, 0.5 for a tie, 0 otherwise
+ */
+template <typename State = GameState, typename First, typename Second>
+double play_game(First &first, Second &second, uint64_t seed, State *final_state = nullptr, int *moves = nullptr) {
+    // splitmix so neighbouring seeds give unrelated dice
+    uint64_t dice = seed + 0x9E3779B97F4A7C15ull;
+    dice          = (dice ^ (dice >> 30)) * 0xBF58476D1CE4E5B9ull;
+    dice          = (dice ^ (dice >> 27)) * 0x94D049BB133111EBull;
+    dice          = (dice ^ (dice >> 31)) | 1;
+
+    State s;
+    int placed = 0;
+    while (!s.is_over()) {
+        dice ^= dice << 13;
+        dice ^= dice >> 7;
+        dice ^= dice << 17;
+        int roll = static_cast<int>((dice >> 32) % State::sides) + 1;
+        int col  = s.turn == 0 ? first.choose(s, roll) : second.choose(s, roll);
+        s.place(col, roll);
+        ++placed;
+    }
+    if (final_state)
+        *final_state = s;
+    if (moves)
+        *moves = placed;
+    int a = s.score(0), b = s.score(1);
+    return a > b ? 1.0 : (a == b ? 0.5 : 0.0);
+}
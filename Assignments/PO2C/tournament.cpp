@@ -0,0 +1,89 @@
+#include "agentClass.hpp"       // computer players
+#include "tournamentClass.hpp"  // parallel tournament and ratings
+#include <chrono>               // timing
+#include <cstdio>               // printf
+#include <cstdlib>              // strtoul
+#include <iostream>             // input/output
+#include <memory>               // unique_ptr
+#include <string>               // string data structure
+#include <vector>               // vector data structure
+
+/*****************************************************************************
+*
+*  Author:           Jack Leary
+*  Email:            jackleary645@gmail.com
+*  Label:            Knucklebones Tournament
+*  Course:           2143 OOP
+*  Semester:         Fall 2024
+*
+*  Description:
+*        Plays the computer players against each other on every core and
+*        prints Elo ratings with 95% confidence intervals. Standings are
+*        printed while the games run so long tournaments can be watched.
+*
+*  Usage:
+*        - Compile with `g++ -std=c++17 -O2 -pthread -o tournament tournament.cpp boardVariants.cpp`
+*        - Run with `./tournament [rr|swiss] [games_per_pairing] [threads] [swiss_rounds]`
+*        - e.g. `./tournament rr 200 8` plays 200 games for every pairing on 8 threads
+*
+*  Files:             tournament.cpp      : driver program for the tournament
+*                     tournamentClass.hpp : scheduling, results and ratings
+*                     agentClass.hpp      : computer players
+*****************************************************************************/
+
+/**
+ * print_standings
+ *
+ * Description:
+ *      Prints one line per agent, best rating first.
+ *
+ * Params:
+ *      const std::vector<Standing>& table : current standings
+ *      int done                           : games finished so far
+ *      int total                          : games in the current batch
+ */
+void print_standings(const std::vector<Standing> &table, int done, int total) {
+    std::printf("-- %d / %d games --\n", done, total);
+    for (const auto &s : table) {
+        double pct = s.games ? 100.0 * s.points / s.games : 0.0;
+        std::printf("%-12s %6.0f +/- %-4.0f %6d games %5.1f%%\n", s.name.c_str(), s.elo, s.elo_ci, s.games, pct);
+    }
+    std::fflush(stdout);
+}
+
+int main(int argc, char **argv) {
+    std::string mode  = argc > 1 ? argv[1] : "rr";
+    int per_pairing   = argc > 2 ? static_cast<int>(std::strtoul(argv[2], nullptr, 10)) : 100;
+    unsigned threads  = argc > 3 ? static_cast<unsigned>(std::strtoul(argv[3], nullptr, 10)) : 0;
+    int swiss_rounds  = argc > 4 ? static_cast<int>(std::strtoul(argv[4], nullptr, 10)) : 3;
+    if ((mode != "rr" && mode != "swiss") || per_pairing <= 0) {
+        std::cerr << "usage: " << argv[0] << " [rr|swiss] [games_per_pairing] [threads] [swiss_rounds]" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::unique_ptr<Agent> > agents;
+    agents.emplace_back(new RandomAgent(7));
+    agents.emplace_back(new GreedyAgent());
+    agents.emplace_back(new ExpectimaxAgent(3));
+    agents.emplace_back(new MctsAgent(std::chrono::milliseconds(1)));
+    agents.emplace_back(new MctsAgent(std::chrono::milliseconds(5)));
+
+    Tournament tournament(std::move(agents), threads);
+    tournament.on_progress(print_standings);
+
+    auto start = std::chrono::steady_clock::now();
+    if (mode == "rr")
+        tournament.round_robin(per_pairing);
+    else
+        tournament.swiss(swiss_rounds, per_pairing);
+    double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::vector<Standing> final_table = tournament.standings();
+    int games = 0;
+    for (const auto &s : final_table)
+        games += s.games;
+    games /= 2;
+    std::cout << "\nfinal standings (" << games << " games in " << secs << "s)" << std::endl;
+    print_standings(final_table, games, games);
+    return 0;
+}
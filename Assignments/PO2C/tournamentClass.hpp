@@ -0,0 +1,255 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "boardState.hpp"
+#include "statsClass.hpp"
+#include "strategyClass.hpp"
+
+/**
+ * Standing
+ *
+ * Description:
+ *      One agent's line in the standings. `elo` is the maximum-likelihood
+ *      Bradley-Terry rating of all games so far (ties count as half a win),
+ *      centred on 1500, and `elo_ci` is the half width of its 95% interval.
+ */
+struct Standing {
+    std::string name;
+    int games     = 0;
+    double points = 0.0;
+    double elo    = 1500.0;
+    double elo_ci = 0.0;
+};
+
+/**
+ * Tournament
+ *
+ * Description:
+ *      Plays agents against each other on a pool of worker threads and rates
+ *      them. Every pairing plays `games_per_pairing` games on seeded dice; each
+ *      dice seed is used twice with the colors swapped, so neither side gets
+ *      luckier rolls. Each worker clones every agent once and keeps the
+ *      copies, so agents never share state across threads.
+ *
+ *      Round robin queues every game at once. Swiss plays `rounds` rounds,
+ *      pairing agents with similar points who have not met yet, and waits for
+ *      each round to finish before pairing the next.
+ *
+ *      While games run, the calling thread wakes every `report_every` and
+ *      hands the current standings to the callback.
+ *
+ * Public Methods:
+ *      - Tournament(std::vector<std::unique_ptr<Agent>> agents, unsigned threads = 0)
+ *      - void round_robin(int games_per_pairing)
+ *      - void swiss(int rounds, int games_per_pairing)
+ *      - std::vector<Standing> standings() const
+ *      - void on_progress(std::function<void(const std::vector<Standing>&, int done, int total)> fn)
+ *      - void set_stats(GameStats* stats) : Also record every finished game into `stats`.
+ *
+ * Usage:
+ *      Tournament t(std::move(agents), 8);
+ *      t.on_progress(print_table);
+ *      t.round_robin(100);
+ */
+class Tournament {
+   public:
+    using Progress = std::function<void(const std::vector<Standing> &, int, int)>;
+
+    Tournament(std::vector<std::unique_ptr<Agent> > agents, unsigned threads = 0)
+        : agents(std::move(agents)), report_every(std::chrono::seconds(1)) {
+        thread_count = threads ? threads : std::max(1u, std::thread::hardware_concurrency());
+        size_t n     = this->agents.size();
+        points.assign(n, std::vector<double>(n, 0.0));
+        games.assign(n, std::vector<int>(n, 0));
+    }
+
+    void on_progress(Progress fn) { progress = std::move(fn); }
+    void set_stats(GameStats *sink) { stats = sink; }
+    void set_report_interval(std::chrono::milliseconds every) { report_every = every; }
+
+    void round_robin(int games_per_pairing) {
+        std::vector<Job> jobs;
+        for (int a = 0; a < static_cast<int>(agents.size()); ++a)
+            for (int b = a + 1; b < static_cast<int>(agents.size()); ++b)
+                add_pairing(jobs, a, b, games_per_pairing);
+        run(jobs);
+    }
+
+    void swiss(int rounds, int games_per_pairing) {
+        std::set<std::pair<int, int> > met;
+        for (int r = 0; r < rounds; ++r) {
+            std::vector<int> order(agents.size());
+            for (size_t i = 0; i < order.size(); ++i)
+                order[i] = static_cast<int>(i);
+            std::vector<double> total = totals();
+            std::stable_sort(order.begin(), order.end(), [&](int x, int y) { return total[x] > total[y]; });
+
+            // pair top-down with the nearest unpaired agent not met before;
+            // with an odd count the last agent sits the round out
+            std::vector<Job> jobs;
+            std::vector<bool> used(order.size(), false);
+            for (size_t i = 0; i < order.size(); ++i) {
+                if (used[i])
+                    continue;
+                size_t pick = order.size();
+                for (size_t j = i + 1; j < order.size(); ++j) {
+                    if (used[j])
+                        continue;
+                    if (pick == order.size())
+                        pick = j;
+                    if (!met.count(std::minmax(order[i], order[j]))) {
+                        pick = j;
+                        break;
+                    }
+                }
+                if (pick == order.size())
+                    continue;
+                used[i] = used[pick] = true;
+                met.insert(std::minmax(order[i], order[pick]));
+                add_pairing(jobs, order[i], order[pick], games_per_pairing);
+            }
+            run(jobs);
+        }
+    }
+
+    std::vector<Standing> standings() const {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        return rate();
+    }
+
+   private:
+    struct Job {
+        int first;   // agent moving first
+        int second;  // agent moving second
+        uint32_t seed;
+    };
+
+    std::vector<std::unique_ptr<Agent> > agents;
+    unsigned thread_count;
+    std::chrono::milliseconds report_every;
+    Progress progress;
+    GameStats *stats = nullptr;
+    uint32_t next_seed = 1;
+
+    mutable std::mutex results_mutex;
+    std::condition_variable finished;
+    std::vector<std::vector<double> > points;  // points[a][b]: what a scored against b
+    std::vector<std::vector<int> > games;      // games[a][b] == games[b][a]
+
+    void add_pairing(std::vector<Job> &jobs, int a, int b, int count) {
+        for (int g = 0; g < count; ++g) {
+            uint32_t seed = next_seed + static_cast<uint32_t>(g / 2);
+            jobs.push_back(g % 2 == 0 ? Job{a, b, seed} : Job{b, a, seed});
+        }
+        next_seed += static_cast<uint32_t>((count + 1) / 2);
+    }
+
+    void run(const std::vector<Job> &jobs) {
+        std::atomic<size_t> next{0};
+        std::atomic<int> done{0};
+        std::vector<std::thread> pool;
+        for (unsigned t = 0; t < thread_count; ++t) {
+            pool.emplace_back([&]() {
+                std::vector<std::unique_ptr<Agent> > mine;
+                for (const auto &a : agents)
+                    mine.push_back(a->clone());
+                for (size_t i = next++; i < jobs.size(); i = next++) {
+                    const Job &job = jobs[i];
+                    GameState final_state;
+                    int moves     = 0;
+                    double result = play_game(*mine[job.first], *mine[job.second], job.seed, &final_state, &moves);
+                    if (stats)
+                        stats->record(final_state, moves);  // per-thread shard, outside the lock
+                    std::lock_guard<std::mutex> lock(results_mutex);
+                    points[job.first][job.second] += result;
+                    points[job.second][job.first] += 1.0 - result;
+                    games[job.first][job.second]++;
+                    games[job.second][job.first]++;
+                    if (++done == static_cast<int>(jobs.size()))
+                        finished.notify_all();
+                }
+            });
+        }
+
+        // stream standings until the last game lands
+        std::unique_lock<std::mutex> lock(results_mutex);
+        while (done < static_cast<int>(jobs.size())) {
+            finished.wait_for(lock, report_every);
+            if (progress)
+                progress(rate(), done, static_cast<int>(jobs.size()));
+        }
+        lock.unlock();
+        for (auto &th : pool)
+            th.join();
+    }
+
+    std::vector<double> totals() const {
+        std::lock_guard<std::mutex> lock(results_mutex);
+        std::vector<double> total(agents.size(), 0.0);
+        for (size_t a = 0; a < agents.size(); ++a)
+            for (size_t b = 0; b < agents.size(); ++b)
+                total[a] += points[a][b];
+        return total;
+    }
+
+    // Bradley-Terry fit by minorization-maximization; caller holds results_mutex
+    std::vector<Standing> rate() const {
+        size_t n = agents.size();
+        std::vector<Standing> out(n);
+        std::vector<double> strength(n, 1.0);
+        for (size_t a = 0; a < n; ++a) {
+            out[a].name = agents[a]->name();
+            for (size_t b = 0; b < n; ++b) {
+                out[a].games += games[a][b];
+                out[a].points += points[a][b];
+            }
+        }
+
+        for (int iter = 0; iter < 200; ++iter) {
+            std::vector<double> next(n, 1.0);
+            for (size_t a = 0; a < n; ++a) {
+                double denom = 0.0;
+                for (size_t b = 0; b < n; ++b) {
+                    if (b != a && games[a][b])
+                        denom += games[a][b] / (strength[a] + strength[b]);
+                }
+                // half a point of prior keeps all-win or all-loss records finite
+                next[a] = denom > 0 ? (out[a].points + 0.5) / (denom + 1.0 / strength[a]) : 1.0;
+            }
+            double log_mean = 0.0;
+            for (double s : next)
+                log_mean += std::log(s);
+            log_mean /= static_cast<double>(n);
+            for (size_t a = 0; a < n; ++a)
+                strength[a] = next[a] / std::exp(log_mean);
+        }
+
+        const double scale = 400.0 / std::log(10.0);
+        for (size_t a = 0; a < n; ++a) {
+            double info = 0.0;  // Fisher information of log strength
+            for (size_t b = 0; b < n; ++b) {
+                if (b == a || !games[a][b])
+                    continue;
+                double p = strength[a] / (strength[a] + strength[b]);
+                info += games[a][b] * p * (1.0 - p);
+            }
+            out[a].elo    = 1500.0 + scale * std::log(strength[a]);
+            out[a].elo_ci = info > 0 ? 1.96 * scale / std::sqrt(info) : 0.0;
+        }
+        std::sort(out.begin(), out.end(), [](const Standing &x, const Standing &y) { return x.elo > y.elo; });
+        return out;
+    }
+};
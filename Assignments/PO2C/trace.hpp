@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "logFormat.hpp"
+#include "logger.hpp"
+
+/**
+ * Trace
+ *
+ * Description:
+ *      Where the time goes, logged through Logger at Level::Trace. A `Span`
+ *      times the scope it is declared in and logs one record when the scope
+ *      ends; `counter` logs a value that changes over time (a score, a queue
+ *      length) and `instant` marks a moment. Each names a Logger::Site
+ *      shaped `LogFormat::Span`, `Counter` or `Instant`, declared static like
+ *      any other site.
+ *
+ *      A span reads the clock when it starts and the record it logs is
+ *      stamped when it ends, so its length costs no extra clock read; with
+ *      `Format::Binary` the record is the site, the thread's number and the
+ *      length. Events never reach the in-memory tail, so the status line
+ *      keeps showing the game's own records.
+ *
+ *      Built with -DLOGGER_MIN_LEVEL=1 or higher everything here compiles to
+ *      nothing. Otherwise it is off until `Logger::setLevel(Level::Trace)`
+ *      turns it on, and costs one relaxed load per span while off. `logDecode -j` turns a binary
+ *      log into Chrome trace-event JSON for chrome://tracing or Perfetto.
+ *
+ * Public Methods:
+ *      - static constexpr bool compiled
+ *      - static bool enabled()
+ *      - class Span(const Logger::Site& site) : Times its scope.
+ *      - static void counter(const Logger::Site& site, T value)
+ *      - static void instant(const Logger::Site& site)
+ *
+ * Usage:
+ *      Logger::setLevel(Logger::Level::Trace);   // once, at startup
+ *      void Grid::drawGrid() {
+ *          static const Logger::Site draw("Grid::drawGrid", LogFormat::Span);
+ *          Trace::Span span(draw);   // "span 1 Grid::drawGrid: 41250 ns"
+ *          ...
+ *      }
+ *      static const Logger::Site score("score", LogFormat::Counter);
+ *      Trace::counter(score, player.get_score());
+ */
+class Trace {
+   public:
+    static constexpr bool compiled = Logger::Level::Trace >= Logger::compiledLevel;
+
+    static bool enabled() {
+        if constexpr (compiled)
+            return Logger::enabled(Logger::Level::Trace);
+        return false;
+    }
+
+    class Span {
+       public:
+        explicit Span(const Logger::Site& site) : site(site) {
+            if constexpr (compiled) {
+                if (enabled())
+                    start = Logger::Clock::now();
+            }
+        }
+
+        ~Span() {
+            if constexpr (compiled) {
+                if (start != 0)
+                    Logger::logEvent(site, Logger::Since{start});
+            }
+        }
+
+        Span(const Span&)            = delete;
+        Span& operator=(const Span&) = delete;
+
+       private:
+        const Logger::Site& site;
+        uint64_t start = 0;  // 0 when tracing was off as the span began
+    };
+
+    template <typename T>
+    static void counter(const Logger::Site& site, T value) {
+        static_assert(std::is_arithmetic_v<T>, "a counter's value is a number");
+        if constexpr (compiled) {
+            if (enabled())
+                Logger::logEvent(site, value);
+        }
+    }
+
+    static void instant(const Logger::Site& site) {
+        if constexpr (compiled) {
+            if (enabled())
+                Logger::logEvent(site);
+        }
+    }
+};
@@ -22,6 +22,7 @@
 
 // Includes SFML graphics library and standard utilities
 #include <SFML/Graphics.hpp>
+#include <array>
 #include <vector>
 #include <iostream>
 #include <random>
@@ -400,9 +401,10 @@ private:
  *
  * Description:
  *      This class represents the game grid, which consists of cells where dice can be placed. It provides functionality to draw the grid, manage dice placements, and animate dice within the grid cells.
+ *      The number of rows and columns are template parameters, so the cell storage is fixed size and the loops over it have constant bounds.
  *
  * Public Methods:
- *      - Grid(int rows, int cols, float cellSize, float cellSpacing, float startX, float startY) - Constructor to initialize the grid with the specified number of rows, columns, and cell sizes.
+ *      - Grid<Rows, Cols>(float cellSize, float cellSpacing, float startX, float startY) - Constructor to initialize the grid with the specified cell sizes.
  *      - void draw(sf::RenderWindow& window) - Draws the grid on the window.
  *      - bool place_dice(int row, int col, int value) - Places a dice in a specific grid cell.
  *      - int get_cell_value(int row, int col) const - Returns the value in a specific grid cell.
@@ -414,23 +416,22 @@ private:
  *      - None.
  *
  * Usage:
- *      - Grid grid(rows, cols, cellSize, cellSpacing, startX, startY);
+ *      - Grid<3, 3> grid(cellSize, cellSpacing, startX, startY);
  *      - grid.draw(window);
  *      - grid.place_dice(row, col, value);
  *      - grid.get_cell_value(row, col);
  */
 
+template <int Rows, int Cols>
 class Grid {
 public:
     /**
      * Public : Grid
      *
      * Description:
-     *      Constructor to initialize the grid with rows, columns, and cell sizes
+     *      Constructor to initialize the grid with cell sizes and position
      *
      * Params:
-     *      - int rows: The number of rows in the grid
-     *      - int cols: The number of columns in the grid
      *      - float cellSize: The size of each cell in the grid
      *      - float cellSpacing: The space between each cell in the grid
      *      - float startX: The starting X coordinate for the grid
@@ -439,7 +440,7 @@ public:
      * Returns:
      *      - None
      */
-    Grid(int rows, int cols, float cellSize, float cellSpacing, float startX, float startY);
+    Grid(float cellSize, float cellSpacing, float startX, float startY);
 
     /**
      * Public : draw
@@ -532,30 +533,25 @@ public:
     Dice& get_dice_animation(int row, int col);
 
 private:
-    int rows, cols;                                       // Grid dimensions
     float cellSize, cellSpacing;                          // Size and spacing of cells
-    std::vector<sf::RectangleShape> cells;                // Cell shapes
-    std::vector<std::vector<int>> gridValues;             // Values stored in the grid
-    std::vector<std::vector<sf::Sprite>> diceSprites;     // Dice sprites
-    std::vector<std::vector<Dice>> diceAnimations;        // Dice animations
+    std::array<sf::RectangleShape, Rows * Cols> cells;    // Cell shapes
+    int gridValues[Rows][Cols] = {};                      // Values stored in the grid
+    sf::Sprite diceSprites[Rows][Cols];                   // Dice sprites
+    std::vector<Dice> diceAnimations;                     // Dice animations, row by row
     float startX, startY;                                 // Starting position for the grid
 };
 
 // Grid constructor implementation
-Grid::Grid(int rows, int cols, float cellSize, float cellSpacing, float startX, float startY)
-    : rows(rows), cols(cols), cellSize(cellSize), cellSpacing(cellSpacing), startX(startX), startY(startY) {
+template <int Rows, int Cols>
+Grid<Rows, Cols>::Grid(float cellSize, float cellSpacing, float startX, float startY)
+    : cellSize(cellSize), cellSpacing(cellSpacing), startX(startX), startY(startY) {
 
-    // Initialize the grid values
-    gridValues.resize(rows, std::vector<int>(cols, 0)); // 0 means no dice placed
-
-    // Initialize dice sprites and animations
-    diceSprites.resize(rows, std::vector<sf::Sprite>(cols));
-    diceAnimations.resize(rows, std::vector<Dice>(cols, Dice(cellSize)));
+    // Initialize dice animations (grid values start at 0, meaning no dice placed)
+    diceAnimations.assign(Rows * Cols, Dice(cellSize));
 
     // Initialize grid cells
-    cells.reserve(rows * cols);
-    for (int row = 0; row < rows; ++row) {
-        for (int col = 0; col < cols; ++col) {
+    for (int row = 0; row < Rows; ++row) {
+        for (int col = 0; col < Cols; ++col) {
             // Set up the cell shape
             sf::RectangleShape cell(sf::Vector2f(cellSize, cellSize));
             cell.setFillColor(sf::Color::White);
@@ -566,19 +562,20 @@ Grid::Grid(int rows, int cols, float cellSize, float cellSpacing, float startX,
             float x = startX + col * (cellSize + cellSpacing);
             float y = startY + row * (cellSize + cellSpacing);
             cell.setPosition(x, y);
-            cells.push_back(cell);
+            cells[row * Cols + col] = cell;
 
             // Initialize dice sprite position
             diceSprites[row][col].setPosition(x, y);
 
             // Initialize dice animation frames (optional)
-            diceAnimations[row][col].loadFrames("images", 1, 24); // Example frames setup
+            diceAnimations[row * Cols + col].loadFrames("images", 1, 24); // Example frames setup
         }
     }
 }
 
 // Draw grid cells on the window
-void Grid::draw(sf::RenderWindow& window) {
+template <int Rows, int Cols>
+void Grid<Rows, Cols>::draw(sf::RenderWindow& window) {
     for (auto& cell : cells) {
         window.draw(cell);
     }
@@ -586,18 +583,21 @@ void Grid::draw(sf::RenderWindow& window) {
 }
 
 // Accessor for dice sprite
-sf::Sprite Grid::get_dice_sprite(int row, int col) const {
+template <int Rows, int Cols>
+sf::Sprite Grid<Rows, Cols>::get_dice_sprite(int row, int col) const {
     return diceSprites[row][col];
 }
 
 // Accessor for dice animation
-Dice& Grid::get_dice_animation(int row, int col) {
-    return diceAnimations[row][col];
+template <int Rows, int Cols>
+Dice& Grid<Rows, Cols>::get_dice_animation(int row, int col) {
+    return diceAnimations[row * Cols + col];
 }
 
 // Place a dice in a specific grid cell
-bool Grid::place_dice(int row, int col, int value) {
-    if (row >= 0 && row < rows && col >= 0 && col < cols) {
+template <int Rows, int Cols>
+bool Grid<Rows, Cols>::place_dice(int row, int col, int value) {
+    if (row >= 0 && row < Rows && col >= 0 && col < Cols) {
         gridValues[row][col] = value;
         return true;
     }
@@ -605,19 +605,25 @@ bool Grid::place_dice(int row, int col, int value) {
 }
 
 // Get the value stored in a specific grid cell
-int Grid::get_cell_value(int row, int col) const {
-    if (row >= 0 && row < rows && col >= 0 && col < cols) {
+template <int Rows, int Cols>
+int Grid<Rows, Cols>::get_cell_value(int row, int col) const {
+    if (row >= 0 && row < Rows && col >= 0 && col < Cols) {
         return gridValues[row][col];
     }
     return -1;  // Invalid position
 }
 
 // Get the graphical representation of a grid cell
-sf::RectangleShape Grid::get_cell(int row, int col) const {
-    int index = row * cols + col;
+template <int Rows, int Cols>
+sf::RectangleShape Grid<Rows, Cols>::get_cell(int row, int col) const {
+    int index = row * Cols + col;
     return cells[index];
 }
 
+// Board sizes used by the game, compiled once here
+template class Grid<3, 3>;
+template class Grid<4, 4>;
+
 /**
  * Public : Game
  *
@@ -640,8 +646,8 @@ void Game(sf::RenderWindow& window) {
     diceAnimation.loadFrames("images", 1, 24);  // Load dice animation frames
 
     // Initialize grid parameters
-    const int rows = 3;
-    const int cols = 3;
+    constexpr int rows = 3;
+    constexpr int cols = 3;
     const float cellSize = 100.f;
     const float cellSpacing = 10.f;
     const float gridStartX1 = 100.f;
@@ -649,8 +655,8 @@ void Game(sf::RenderWindow& window) {
     const float gridStartX2 = gridStartX1 + (cols * (cellSize + cellSpacing)) + 100.f;
 
     // Create two grids for the game
-    Grid grid1(rows, cols, cellSize, cellSpacing, gridStartX1, gridStartY);
-    Grid grid2(rows, cols, cellSize, cellSpacing, gridStartX2, gridStartY);
+    Grid<rows, cols> grid1(cellSize, cellSpacing, gridStartX1, gridStartY);
+    Grid<rows, cols> grid2(cellSize, cellSpacing, gridStartX2, gridStartY);
 
     // Initialize dice and animations for both grids
     std::vector<std::vector<sf::Sprite>> diceSprites1(rows, std::vector<sf::Sprite>(cols));